@@ -29,13 +29,16 @@
 
 PXR_NAMESPACE_OPEN_SCOPE
 
-class HUSD_LopStageFactory : public XUSD_StageFactory
+class HUSD_LopStageFactory : public XUSD_StageFactory,
+			     public XUSD_ResolverContextProvider
 {
 public:
     virtual int			 getPriority() const override
 				 { return 0; }
     virtual UsdStageRefPtr	 createStage(UsdStage::InitialLoadSet loadset,
 					int nodeid) const override;
+    virtual bool		 getResolverContext(int nodeid,
+					ArResolverContext &context) const override;
 };
 
 PXR_NAMESPACE_CLOSE_SCOPE
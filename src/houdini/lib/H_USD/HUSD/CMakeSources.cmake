@@ -92,6 +92,7 @@ set( husd_sources
     XUSD_OverridesData.C
     XUSD_PathPattern.C
     XUSD_PathSet.C
+    XUSD_PrimIndex.C
     XUSD_RenderSettings.C
     XUSD_ViewerDelegate.C
     XUSD_Ticket.C
@@ -192,6 +193,7 @@ set( husd_hdk_headers
     XUSD_OverridesData.h
     XUSD_PathPattern.h
     XUSD_PathSet.h
+    XUSD_PrimIndex.h
     XUSD_RenderSettings.h
     XUSD_Ticket.h
     XUSD_TicketRegistry.h
@@ -43,6 +43,23 @@ enum class HUSD_TimeSampling;
 class UT_OpCaller;
 class UT_StringArray;
 
+/// Statistics about running CVEX code, accumulated over all the runs
+/// of an HUSD_Cvex object, useful for tuning how the work is scheduled.
+/// Times are in seconds. Load and block times are summed over all threads.
+struct HUSD_CvexTimings
+{
+    exint	myRunCount = 0;		    // Separate data sets run on.
+    exint	myThreadedRunCount = 0;	    // Runs that used many threads.
+    exint	myElementCount = 0;	    // Elements processed in all runs.
+    exint	myBlockCount = 0;	    // Blocks the elements were split into.
+    exint	myStolenBlockCount = 0;	    // Blocks taken from other threads.
+    fpreal64	myEstimatedCost = 0;	    // Relative cost of all elements.
+    fpreal64	mySetupTime = 0;	    // Estimating costs and blocks.
+    fpreal64	myLoadTime = 0;		    // Loading the CVEX code.
+    fpreal64	myBlockTime = 0;	    // Binding and running the blocks.
+    fpreal64	myTotalTime = 0;	    // Wall clock time of all the runs.
+};
+
 
 class HUSD_API HUSD_Cvex
 {
@@ -148,6 +165,21 @@ public:
     /// Returns ture if any attribute the CVEX has run on has time sample(s).
     bool	 getIsTimeSampled() const;
 
+    /// Vexpression code loaded for running is kept in a process-wide cache,
+    /// so that subsequent runs of the same code with the same bindings 
+    /// don't need to load it again. These return the number of times
+    /// a thread found or didn't find its code already loaded in that cache.
+    static exint getCompiledCodeCacheHits();
+    static exint getCompiledCodeCacheMisses();
+
+    /// Frees all the cached code and resets the hit and miss counts.
+    static void	 clearCompiledCodeCache();
+
+    /// Returns the timing and scheduling statistics of all the CVEX runs
+    /// performed by this object since it was created or last cleared.
+    const HUSD_CvexTimings &getTimings() const;
+    void	 clearTimings();
+
 protected:
     const HUSD_CvexBindingMap &	    getBindingsMap() const;
 
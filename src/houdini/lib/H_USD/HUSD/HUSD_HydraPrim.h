@@ -90,6 +90,10 @@ public:
     virtual bool	 getBounds(UT_BoundingBox &box) const;
 
     static int		 newUniqueId();
+    // Reserve a block of 'count' consecutive ids, returning the first one.
+    static int		 newUniqueIdRange(int count);
+    // One past the largest id handed out so far.
+    static int		 maxUniqueId();
     
     // Data is owned once set.
     void		 setExtraData(HUSD_HydraPrimData *data);
@@ -77,6 +77,8 @@ public:
     void		 setStage(const HUSD_DataHandle &data_handle,
 				const HUSD_ConstOverridesPtr &overrides);
     void		 setSelection(const UT_StringArray &paths);
+    // Changing the frame during a background update stops the update from
+    // syncing any more prims. The new frame is used by the next update.
     bool		 setFrame(fpreal frame);
     bool		 setHeadlight(bool doheadlight);
     void		 setLighting(bool enable);
@@ -91,7 +93,10 @@ public:
     
     bool                 canBackgroundRender(const UT_StringRef &name) const;
 
-    // Fire off a render and return immediately.
+    // Fire off a render and return immediately. If an update is already
+    // running in the background with the same renderer and options, this
+    // request replaces any other waiting request, and runs as soon as the
+    // current update finishes.
     // Only call if canBackgroundRender() returns true.
     bool                 launchBackgroundRender(const UT_Matrix4D &view_matrix,
                                                 const UT_Matrix4D &proj_matrix,
@@ -183,6 +188,7 @@ public:
 
 private:
     class husd_ImagingPrivate;
+    class husd_UpdateRequest;
 
     void		 updateLightsAndCameras();
     void		 updateDeferredPrims();
@@ -193,10 +199,12 @@ private:
     void                 updateSettingIfRequired(const char *key,
                                 const T &value);
     void                 updateSettingsIfRequired();
-    RunningStatus	 updateRenderData(const UT_Matrix4D &view_matrix,
-                                          const UT_Matrix4D &proj_matrix,
-                                          const UT_DimRect &viewport_rect,
-                                          bool update_deferred);
+    void		 applyFrame(fpreal frame);
+    void		 finishPendingFrame();
+    RunningStatus	 updateRenderData(const husd_UpdateRequest &request);
+    void		 queueBackgroundUpdate(husd_UpdateRequest *request);
+    void		 runBackgroundUpdates();
+    void		 stopBackgroundUpdates();
     void		 finishRender(bool do_render);
 
     UT_UniquePtr<husd_ImagingPrivate>	 myPrivate;
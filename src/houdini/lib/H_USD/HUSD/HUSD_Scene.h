@@ -30,16 +30,21 @@
 #include <pxr/pxr.h>
 
 #include "HUSD_API.h"
+#include <UT/UT_BitArray.h>
+#include <UT/UT_IntArray.h>
 #include <UT/UT_Lock.h>
 #include <UT/UT_LinkList.h>
 #include <UT/UT_Map.h>
 #include <UT/UT_NonCopyable.h>
 #include <UT/UT_Pair.h>
+#include <UT/UT_RWLock.h>
 #include <UT/UT_StringArray.h>
 #include <UT/UT_StringMap.h>
 #include <UT/UT_StringSet.h>
+#include <UT/UT_ThreadSpecificValue.h>
 #include <UT/UT_IntrusivePtr.h>
 #include <UT/UT_Vector2.h>
+#include <SYS/SYS_AtomicInt.h>
 #include <SYS/SYS_Types.h>
 #include "HUSD_PrimHandle.h"
 #include "HUSD_Overrides.h"
@@ -69,13 +74,21 @@ public:
 	     HUSD_Scene();
     virtual ~HUSD_Scene();
 
-    UT_StringMap<HUSD_HydraGeoPrimPtr>  &geometry() { return myDisplayGeometry; }
+    UT_StringMap<HUSD_HydraGeoPrimPtr>  &geometry()
+				{ commitPendingGeometry();
+				  return myDisplayGeometry; }
     UT_StringMap<HUSD_HydraCameraPtr>   &cameras()  { return myCameras; }
     UT_StringMap<HUSD_HydraLightPtr>    &lights()   { return myLights; }
     UT_StringMap<HUSD_HydraMaterialPtr> &materials(){ return myMaterials; }
 
     // all of these return true if the list was modified, false if the serial
     // matched;
+    // Geometry added to the display during a Hydra sync is staged per thread
+    // so that parallel Rprim syncs don't contend on the display lock. This
+    // merges the staged geometry into the display list, and is called once
+    // the sync completes. It must not be called while a sync is running.
+    void        commitPendingGeometry();
+
     bool        fillGeometry(UT_Array<HUSD_HydraGeoPrimPtr> &array,
                              int64 &list_serial);
     bool        fillLights(UT_Array<HUSD_HydraLightPtr> &array,
@@ -132,7 +145,13 @@ public:
     void         setRenderPrimResolution(UT_Vector2I res) {myRenderPrimRes=res;}
 
     void	 deferUpdates(bool defer) { myDeferUpdate = defer; }
-    bool	 isDeferredUpdate() const { return myDeferUpdate; }
+    bool	 isDeferredUpdate() const
+		 { return myDeferUpdate || myCancelSync.relaxedLoad(); }
+
+    // Have the prims that haven't been synced yet in the current update
+    // defer their updates instead, so that a newer update can start sooner.
+    void	 cancelSync(bool cancel) { myCancelSync.store(cancel ? 1 : 0); }
+    bool	 isSyncCancelled() const { return myCancelSync.relaxedLoad(); }
     
     // Volumes
     const UT_StringSet &volumesUsingField(const UT_StringRef &field) const;
@@ -213,6 +232,14 @@ public:
 
     int		getOrCreateID(const UT_StringRef &path,
                               PrimType type = GEOMETRY);
+
+    // Reserve IDs for the instances of a point instancer, so that the
+    // instance with index i has the ID (return value + i). The instances
+    // are named "instancer_path[i]", but these names are only created when
+    // the ID is looked up, so huge point instancers don't need millions of
+    // strings. The IDs stay the same as long as num_indices doesn't grow.
+    int		reserveInstanceIDs(const UT_StringRef &instancer_path,
+                                   int num_indices);
     
     void	setStage(const HUSD_DataHandle &data,
 			 const HUSD_ConstOverridesPtr &overrides);
@@ -257,9 +284,97 @@ protected:
     int          getIDForPrim(const UT_StringRef &path,
                               PrimType &return_prim_type,
                               bool create_path_id = false);
+
+    // Find the name of an ID from reserveInstanceIDs(). Returns false if the
+    // ID wasn't reserved by a point instancer.
+    bool         getInstanceName(int id, UT_StringHolder &name) const;
+    // Return the ID reserved for an instance name like "instancer[i]", or
+    // -1 if the name doesn't refer to a point instancer's instance.
+    int          findInstanceID(const UT_StringRef &path) const;
+    // Add the name of an ID from reserveInstanceIDs() to myNameIDLookup, so
+    // it can be found like any other ID. Returns the path of the ID.
+    const UT_StringRef &addInstanceName(int id);
+    // Index of the instance ID block containing the ID, or -1.
+    // myInstanceIDLock must be held.
+    exint        findInstanceIDBlock(int id) const;
+
+    // Give an ID a name, and add it to the node for its path in the ID
+    // hierarchy. myIDLock must be held for writing.
+    void         registerID(int id, const UT_StringHolder &path,
+                            PrimType type);
+    void         unregisterID(int id);
+    // Find or create the hierarchy node for a path, and its ancestors.
+    // myIDLock must be held for writing.
+    int          findOrCreateIDNode(const UT_StringRef &path);
+
+    class IDSet;
+    // The selected or highlighted IDs, including the IDs of everything
+    // selected through a parent branch or instancer. The sets are resolved
+    // on demand; read them with myIDLock held.
+    const IDSet &selectedIDs() const;
+    const IDSet &highlightedIDs() const;
+    void         resolveIDSet(const UT_Map<int,int> &ids, int64 serial,
+                              bool leaf_instances, IDSet &set) const;
+    // Test an ID that may be newer than the set. myIDLock must be held.
+    bool         isInIDSet(const IDSet &set, int id) const;
+    // Test an ID against the set's nodes rather than its ID bits.
+    bool         isInIDSetHierarchy(const IDSet &set, int id) const;
+    void         dirtyInstancedGeometry();
+
+    class InstanceIDBlock
+    {
+    public:
+        UT_StringHolder  myInstancer;
+        int              myInstancerNode;
+        int              myStartID;
+        int              mySize;
+    };
+
+    // A path in the ID hierarchy. Several IDs may name the same path, such
+    // as a geometry prim and a branch selection of it.
+    class IDNode
+    {
+    public:
+        UT_StringHolder  myPath;
+        UT_IntArray      myIDs;
+        UT_IntArray      myChildren;
+        int              myParent;
+        bool             myIsInstance;
+        bool             myIsInstancer;
+    };
+
+    class IDSet
+    {
+    public:
+        IDSet() : mySerial(-1), myLeafInstances(false) {}
+
+        // One bit per ID, sized to the largest ID when resolved.
+        UT_BitArray      myIDs;
+        // Nodes whose whole subtree is in the set, and nodes that are in
+        // the set themselves.
+        UT_BitArray      mySubtreeNodes;
+        UT_BitArray      myLeafNodes;
+        // Written under the write lock, but checked without it to see if
+        // the set needs resolving.
+        SYS_AtomicInt64  mySerial;
+        bool             myLeafInstances;
+    };
   
     UT_Map<int, UT_Pair<UT_StringHolder, PrimType> >	myNameIDLookup;
     UT_StringMap<int>			myPathIDs;
+    UT_Array<IDNode>			myIDNodes;
+    UT_StringMap<int>			myIDNodeMap;
+    UT_Map<int,int>			myIDNodeLookup;
+    UT_Map<int,HUSD_HydraPrim *>	myIDPrims;
+    mutable IDSet			mySelectedIDs;
+    mutable IDSet			myHighlightedIDs;
+    int64				myInstancesDirtySelectionID;
+    int64				myInstancesDirtyHighlightID;
+    // Blocks of instance IDs in increasing ID order. A point instancer gets
+    // a new block if it outgrows its current one, but the old block remains
+    // so that the old IDs can still be named.
+    UT_Array<InstanceIDBlock>		myInstanceIDBlocks;
+    UT_StringMap<exint>			myInstanceIDBlockMap;
     UT_Map<int,UT_StringHolder>		myRenderPaths;
     UT_StringMap<int>                   myRenderIDs;
     UT_Map<int,int>                     myRenderIDtoGeomID;
@@ -294,9 +409,18 @@ protected:
     UT_Vector2I                         myRenderPrimRes;
 
     UT_Lock				myDisplayLock;
+    // Guards myPathIDs, myNameIDLookup and the ID hierarchy when IDs are
+    // created during a sync.
+    mutable UT_RWLock			myIDLock;
+    UT_RWLock				myMatIDLock;
+    UT_ThreadSpecificValue<UT_Array<HUSD_HydraGeoPrimPtr> >
+					myPendingDisplayGeometry;
+    SYS_AtomicInt32			myPendingDisplayCount;
+    SYS_AtomicInt32			myCancelSync;
     UT_Lock				myLightCamLock;
     UT_Lock				myMaterialLock;
     UT_Lock                             myCategoryLock;
+    mutable UT_Lock                     myInstanceIDLock;
 
     UT_StringMap<int>                   myLightLinkCategories;
     UT_StringMap<int>                   myShadowLinkCategories;
@@ -102,6 +102,14 @@ template<typename UT_VALUE_TYPE>
 HUSD_API VtValue
 HUSDgetVtValue( const UT_VALUE_TYPE &ut_value );
 
+/// Converts a UT_* value object to a VtValue holding the value type of
+/// attributes of the given @p type_name, the same way HUSDsetAttribute()
+/// converts values. Returns an empty VtValue if there is no conversion.
+template<typename UT_VALUE_TYPE>
+HUSD_API VtValue
+HUSDgetVtValueOfType( const UT_VALUE_TYPE &ut_value,
+	const SdfValueTypeName &type_name );
+
 
 /// Returns the type of a shader input attribute given the VOP node input.
 HUSD_API SdfValueTypeName   HUSDgetShaderAttribSdfTypeName( 
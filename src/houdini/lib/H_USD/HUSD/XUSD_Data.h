@@ -91,6 +91,72 @@ public:
 
 typedef UT_Array<XUSD_LayerAtPath>	 XUSD_LayerAtPathArray;
 
+// Copy-on-write wrapper around one of the arrays held by an XUSD_Data. Most
+// LOP nodes pass the arrays of their input through unchanged, so copying
+// just shares the array, and the array gets copied only when it is about
+// to be modified while shared. The const accessors match those of UT_Array
+// so reading the array looks the same as before. Modifying it requires
+// calling edit() first.
+template <typename ARRAY>
+class XUSD_SharedArray
+{
+public:
+    typedef typename ARRAY::value_type	value_type;
+
+				 XUSD_SharedArray()
+				 { }
+
+    exint			 size() const
+				 { return myArray ? myArray->size() : 0; }
+    bool			 isEmpty() const
+				 { return size() == 0; }
+    const value_type		&operator()(exint i) const
+				 { return (*myArray)(i); }
+    const value_type		&last() const
+				 { return myArray->last(); }
+    typename ARRAY::const_iterator begin() const
+				 { return array().begin(); }
+    typename ARRAY::const_iterator end() const
+				 { return array().end(); }
+
+    const ARRAY			&array() const
+				 { return myArray ? *myArray : theEmptyArray; }
+				 operator const ARRAY &() const
+				 { return array(); }
+
+    // Returns true if both objects share the same array.
+    bool			 isSharedWith(const XUSD_SharedArray &other) const
+				 { return myArray == other.myArray; }
+
+    // Returns an array we can modify, copying the array first if it is
+    // shared with any other XUSD_SharedArray.
+    ARRAY			&edit()
+				 {
+				     if (!myArray)
+					 myArray.reset(new ARRAY());
+				     else if (myArray.use_count() > 1)
+					 myArray.reset(new ARRAY(*myArray));
+				     return *myArray;
+				 }
+
+    XUSD_SharedArray		&operator=(const ARRAY &array)
+				 {
+				     myArray.reset(new ARRAY(array));
+				     return *this;
+				 }
+    void			 clear()
+				 { myArray.reset(); }
+
+private:
+    UT_SharedPtr<ARRAY>		 myArray;
+    static const ARRAY		 theEmptyArray;
+};
+
+template <typename ARRAY>
+const ARRAY XUSD_SharedArray<ARRAY>::theEmptyArray;
+
+typedef XUSD_SharedArray<XUSD_LayerAtPathArray>	XUSD_SharedLayerAtPathArray;
+
 class HUSD_API XUSD_Data : public UT_IntrusiveRefCounter<XUSD_Data>,
 			   public UT_NonCopyable
 {
@@ -221,6 +287,7 @@ private:
 				bool remove_layer_breaks = false);
     XUSD_LayerPtr	 editActiveSourceLayer();
     void                 createInitialPlaceholderSublayers();
+    void		 recycleStage();
     void		 afterRelease();
 
     static void		 exitCallback(void *);
@@ -230,12 +297,16 @@ private:
     UT_SharedPtr<XUSD_LayerArray>	 myStageLayers;
     UT_SharedPtr<int>			 myStageLayerCount;
     UT_SharedPtr<XUSD_OverridesInfo>	 myOverridesInfo;
-    XUSD_LayerAtPathArray		 mySourceLayers;
+    // The source layers last applied to the sublayers of the stage by
+    // afterLock(), if the stage layers still match them exactly. Shared
+    // with all the data sharing the stage.
+    UT_SharedPtr<XUSD_SharedLayerAtPathArray> myStageSourceLayers;
+    XUSD_SharedLayerAtPathArray		 mySourceLayers;
     HUSD_LoadMasksPtr			 myLoadMasks;
     XUSD_DataLockPtr			 myDataLock;
-    XUSD_TicketArray			 myTicketArray;
-    XUSD_LayerArray			 myReplacementLayerArray;
-    HUSD_LockedStageArray		 myLockedStages;
+    XUSD_SharedArray<XUSD_TicketArray>	 myTicketArray;
+    XUSD_SharedArray<XUSD_LayerArray>	 myReplacementLayerArray;
+    XUSD_SharedArray<HUSD_LockedStageArray> myLockedStages;
     HUSD_MirroringType			 myMirroring;
     UsdStageLoadRules                    myMirrorLoadRules;
     bool                                 myMirrorLoadRulesChanged;
@@ -27,7 +27,10 @@
 
 #include "HUSD_API.h"
 #include "HUSD_PathPattern.h"
+#include "XUSD_PathSet.h"
+#include <UT/UT_Array.h>
 #include <pxr/usd/sdf/path.h>
+#include <pxr/base/tf/token.h>
 
 PXR_NAMESPACE_OPEN_SCOPE
 
@@ -39,9 +42,9 @@ public:
     virtual	~XUSD_SpecialTokenData()
 		 { }
 
-    SdfPathSet	 myExpandedCollectionPathSet;
-    SdfPathSet	 myCollectionPathSet;
-    SdfPathSet	 myVexpressionPathSet;
+    XUSD_PathSet myExpandedCollectionPathSet;
+    XUSD_PathSet myCollectionPathSet;
+    XUSD_PathSet myVexpressionPathSet;
 };
 
 class HUSD_API XUSD_PathPattern : public HUSD_PathPattern
@@ -57,9 +60,83 @@ public:
 				const HUSD_TimeCode &timecode);
 			~XUSD_PathPattern();
 
-    void		 getSpecialTokenPaths(SdfPathSet &collection_paths,
-				SdfPathSet &expanded_collection_paths,
-				SdfPathSet &vexpression_paths) const;
+    void		 getSpecialTokenPaths(XUSD_PathSet &collection_paths,
+				XUSD_PathSet &expanded_collection_paths,
+				XUSD_PathSet &vexpression_paths) const;
+
+    // Fills tokens with the strings of all the absolute path tokens in
+    // this pattern. Returns false if the pattern also contains special
+    // tokens or anything else that can only be evaluated by matches().
+    bool		 getAbsolutePathTokens(UT_StringArray &tokens) const;
+};
+
+// A path pattern compiled for matching prims during a traversal. Matching
+// works on path element tokens, advancing a small state from each prim to
+// its children, instead of building and matching a string per prim.
+//
+// The compiled form is conservative. It never rejects a path that the
+// source pattern would match, so prims it rejects can be skipped, along
+// with their whole subtree once no descendant can match either. Prims it
+// accepts must still be confirmed with XUSD_PathPattern::matches().
+class HUSD_API XUSD_CompiledPathPattern
+{
+public:
+    // The positions within each compiled path that a prim path reaches.
+    typedef UT_Array<int>	 State;
+
+    explicit		 XUSD_CompiledPathPattern(
+				const XUSD_PathPattern &pattern);
+			~XUSD_CompiledPathPattern();
+
+    // Returns false if the pattern couldn't be compiled, in which case
+    // every prim has to be tested with XUSD_PathPattern::matches().
+    bool		 isValid() const
+			 { return myIsValid; }
+
+    // Returns the state of the absolute root path.
+    void		 getRootState(State &state) const;
+    // Returns the state of the child named name of a path in state parent.
+    void		 advance(const State &parent,
+				const TfToken &name,
+				State &state) const;
+    // Returns the state of an arbitrary path.
+    void		 getState(const SdfPath &path, State &state) const;
+
+    // Returns true if a path in this state may match the pattern.
+    bool		 canMatch(const State &state) const;
+    // Returns true if any descendant of a path in this state may match.
+    bool		 canMatchDescendants(const State &state) const;
+
+private:
+    enum ElementType
+    {
+	ELEMENT_LITERAL,
+	ELEMENT_GLOB,
+	ELEMENT_ANY,
+	ELEMENT_RECURSIVE
+    };
+    struct Element
+    {
+	ElementType	 myType;
+	TfToken		 myLiteral;
+	UT_StringHolder	 myGlob;
+    };
+
+    bool		 compilePath(const UT_StringRef &path);
+    bool		 matchElement(const Element &element,
+				const TfToken &name) const;
+    void		 addWithClosure(int path, int pos,
+				State &state) const;
+
+    static int		 encode(int path, int pos)
+			 { return (path << 16) | pos; }
+    static int		 decodePath(int entry)
+			 { return entry >> 16; }
+    static int		 decodePos(int entry)
+			 { return entry & 0xffff; }
+
+    UT_Array<UT_Array<Element> >	 myPaths;
+    bool				 myIsValid;
 };
 
 PXR_NAMESPACE_CLOSE_SCOPE
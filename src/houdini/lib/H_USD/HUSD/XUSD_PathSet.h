@@ -26,18 +26,111 @@
 #define __XUSD_PathSet_h__
 
 #include "HUSD_API.h"
+#include <UT/UT_Lock.h>
+#include <SYS/SYS_AtomicInt.h>
 #include <pxr/usd/sdf/path.h>
+#include <algorithm>
 
 PXR_NAMESPACE_OPEN_SCOPE
 
-class HUSD_API XUSD_PathSet : public SdfPathSet
+// A set of paths stored as a sorted vector, with the container interface
+// of SdfPathSet. Paths added out of order are appended to an unsorted tail
+// which is sorted and merged in one batch the next time the set is read,
+// so building a set from a traversal costs a single sort. Reads from
+// multiple threads are safe as long as nothing modifies the set.
+class HUSD_API XUSD_PathSet
 {
 public:
+    typedef SdfPath				 value_type;
+    typedef SdfPathVector::const_iterator	 const_iterator;
+    typedef const_iterator			 iterator;
+
 			 XUSD_PathSet();
+			 XUSD_PathSet(const SdfPathSet &paths);
+			 XUSD_PathSet(const XUSD_PathSet &src);
+			 XUSD_PathSet(XUSD_PathSet &&src);
 			~XUSD_PathSet();
+
+    XUSD_PathSet	&operator=(const XUSD_PathSet &src);
+    XUSD_PathSet	&operator=(XUSD_PathSet &&src);
+    XUSD_PathSet	&operator=(const SdfPathSet &paths);
+
+    bool		 operator==(const XUSD_PathSet &other) const;
+    bool		 operator!=(const XUSD_PathSet &other) const
+			 { return !(*this == other); }
+
+    bool		 empty() const
+			 { return myPaths.empty(); }
+    size_t		 size() const
+			 { sortPaths(); return myPaths.size(); }
+    void		 clear();
+    void		 reserve(size_t size)
+			 { myPaths.reserve(size); }
+
+    const_iterator	 begin() const
+			 { sortPaths(); return myPaths.cbegin(); }
+    const_iterator	 end() const
+			 { sortPaths(); return myPaths.cend(); }
+    const_iterator	 find(const SdfPath &path) const;
+    const_iterator	 lower_bound(const SdfPath &path) const;
+    bool		 contains(const SdfPath &path) const;
+    size_t		 count(const SdfPath &path) const
+			 { return contains(path) ? 1 : 0; }
+
+    void		 insert(const SdfPath &path);
+    template <typename IT>
+    void		 insert(IT first, IT last)
+			 {
+			     for (; first != last; ++first)
+				 insert(*first);
+			 }
+    template <typename... ARGS>
+    void		 emplace(ARGS &&...args)
+			 { insert(SdfPath(std::forward<ARGS>(args)...)); }
+    size_t		 erase(const SdfPath &path);
+    const_iterator	 erase(const_iterator it);
+    // Removes every path for which func returns true, in a single pass.
+    template <typename FUNC>
+    void		 removeIf(const FUNC &func)
+			 {
+			     sortPaths();
+			     myPaths.erase(std::remove_if(myPaths.begin(),
+				 myPaths.end(), func), myPaths.end());
+			     mySortedSize = myPaths.size();
+			 }
+    void		 swap(XUSD_PathSet &other);
+
+    // Set operations, each a linear merge of the two sorted vectors.
+    void		 unionWith(const XUSD_PathSet &other);
+    void		 intersectWith(const XUSD_PathSet &other);
+    void		 subtract(const XUSD_PathSet &other);
+
+    // Returns true if the set contains a strict ancestor of path.
+    bool		 containsAncestor(const SdfPath &path) const;
+    // Returns true if the set contains path or any ancestor of it.
+    bool		 containsPathOrAncestor(const SdfPath &path) const
+			 { return contains(path) || containsAncestor(path); }
+    // Returns true if the set contains path or any descendant of it.
+    bool		 containsPathOrDescendant(const SdfPath &path) const;
+
+    const SdfPathVector	&getSdfPathVector() const
+			 { sortPaths(); return myPaths; }
+    SdfPathSet		 getSdfPathSet() const;
+
+private:
+    void		 sortPaths() const
+			 {
+			     if (!myIsSorted.load())
+				 sortPendingPaths();
+			 }
+    void		 sortPendingPaths() const;
+
+    mutable SdfPathVector	 myPaths;
+    mutable size_t		 mySortedSize;
+    mutable SYS_AtomicInt32	 myIsSorted;
+    mutable UT_Lock		 myLock;
 };
 
 PXR_NAMESPACE_CLOSE_SCOPE
 
 #endif
-
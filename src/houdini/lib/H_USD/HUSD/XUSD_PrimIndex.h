@@ -0,0 +1,75 @@
+/*
+ * Copyright 2019 Side Effects Software Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Produced by:
+ *	Side Effects Software Inc.
+ *	123 Front Street West, Suite 1401
+ *	Toronto, Ontario
+ *      Canada   M5J 2M2
+ *	416-504-9876
+ *
+ */
+
+#ifndef __XUSD_PrimIndex_h__
+#define __XUSD_PrimIndex_h__
+
+#include "HUSD_API.h"
+#include "HUSD_Utils.h"
+#include "XUSD_PathSet.h"
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/sdf/path.h>
+#include <pxr/base/tf/token.h>
+#include <pxr/base/tf/type.h>
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+// Secondary indexes of the prims on a stage by schema type, kind, and
+// computed purpose. An index is built the first time a stage is queried
+// with a given set of traversal demands, and is then kept up to date by
+// listening to change notices from the stage. Only the subtrees affected
+// by a change are visited again on the next query. Edits to instance
+// masters rebuild the indexes that include instance proxies.
+//
+// Each query adds the paths of the matching prims that would be visited by
+// traversing the subtree at root with the predicate for the demands. A
+// query returns false without adding anything if the index can't answer
+// it, in which case the caller has to traverse the stage itself.
+class HUSD_API XUSD_PrimIndex
+{
+public:
+    static bool		 findPrimsOfType(const UsdStageRefPtr &stage,
+				HUSD_PrimTraversalDemands demands,
+				const SdfPath &root,
+				const TfType &type,
+				XUSD_PathSet &paths);
+    static bool		 findPrimsOfKind(const UsdStageRefPtr &stage,
+				HUSD_PrimTraversalDemands demands,
+				const SdfPath &root,
+				const TfToken &kind,
+				XUSD_PathSet &paths);
+    static bool		 findPrimsWithPurpose(const UsdStageRefPtr &stage,
+				HUSD_PrimTraversalDemands demands,
+				const SdfPath &root,
+				const TfToken &purpose,
+				XUSD_PathSet &paths);
+
+    // Discards the indexes of all stages.
+    static void		 clear();
+};
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif
+
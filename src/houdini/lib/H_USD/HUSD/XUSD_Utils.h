@@ -33,6 +33,7 @@
 #include <UT/UT_StringArray.h>
 #include <UT/UT_StringMMPattern.h>
 #include <UT/UT_Map.h>
+#include <pxr/usd/ar/resolverContext.h>
 #include <pxr/usd/sdf/fileFormat.h>
 #include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/sdf/layerOffset.h>
@@ -64,6 +65,20 @@ public:
 					int nodeid) const = 0;
 };
 
+// Stage factories that can report the resolver context createStage() would
+// use, without creating a stage, should also derive from this class. This
+// lets us reuse an existing empty stage with the same resolver context
+// instead of creating a new one.
+class HUSD_API XUSD_ResolverContextProvider
+{
+public:
+    virtual			~XUSD_ResolverContextProvider();
+
+    // Returns false if this factory would not create a stage for the node.
+    virtual bool		 getResolverContext(int nodeid,
+					ArResolverContext &context) const = 0;
+};
+
 extern "C" {
     SYS_VISIBILITY_EXPORT extern void newStageFactory(
 	UT_Array<XUSD_StageFactory *> *factories);
@@ -289,6 +304,17 @@ HUSDcopyLayerMetadata(const SdfLayerHandle &srclayer,
 HUSD_API bool
 HUSDclearLayerMetadata(const SdfLayerHandle &destlayer);
 
+// Makes the destination layer match the source layer, like
+// SdfLayer::TransferContent, but only authors the fields and specs that
+// differ between the two layers. So a stage using the destination layer
+// gets change notifications only for what actually changed. Returns false
+// without touching the destination layer if the layers differ in ways this
+// function doesn't reconcile (such as reordered prims or changed variant
+// sets), in which case it should be filled with TransferContent.
+HUSD_API bool
+HUSDtransferLayerDelta(const SdfLayerHandle &srclayer,
+	const SdfLayerHandle &destlayer);
+
 // Utility function used for stitching stages together and saving them.
 HUSD_API void
 HUSDaddExternalReferencesToLayerMap(const SdfLayerRefPtr &layer,
@@ -325,6 +351,23 @@ HUSDcreateStageInMemory(const HUSD_LoadMasks *load_masks,
 	const UsdStageWeakPtr &resolver_context_state = UsdStageWeakPtr(),
 	const ArResolverContext *resolver_context = nullptr);
 
+// Set the stage population mask, the layer muting, and the load rules of
+// a stage from the values in a load masks object. This is the configuration
+// applied by the second version of HUSDcreateStageInMemory.
+HUSD_API void
+HUSDapplyStageLoadMasks(const UsdStageRefPtr &stage,
+	const HUSD_LoadMasks &load_masks);
+
+// Get the path resolver context that HUSDcreateStageInMemory would give a
+// stage created with the same arguments, without creating a stage. Returns
+// false if the resolver context can't be determined without creating the
+// stage.
+HUSD_API bool
+HUSDgetStageResolverContext(int resolver_context_nodeid,
+	const UsdStageWeakPtr &resolver_context_stage,
+	const ArResolverContext *resolver_context,
+	ArResolverContext &context);
+
 // Create a new anonymous layer. Usd this method instead of calling
 // SdfLayer::CreateAnonymous directly, as we want to configure the layer
 // with some common default data.
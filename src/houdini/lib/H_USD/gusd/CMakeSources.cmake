@@ -13,6 +13,8 @@ set( gusd_sources
     GT_PackedUSD.cpp
     GT_PointInstancer.cpp
     GT_PrimCache.cpp
+    GT_PrimDiskCache.cpp
+    GT_ReverseWindingArray.cpp
     GT_Utils.cpp
     GU_PackedUSD.cpp
     GU_USD.cpp
@@ -65,6 +67,8 @@ set( gusd_hdk_headers
     GT_PackedUSD.h
     GT_PointInstancer.h
     GT_PrimCache.h
+    GT_PrimDiskCache.h
+    GT_ReverseWindingArray.h
     GT_Utils.h
     GT_VtArray.h
     GT_VtStringArray.h
@@ -367,6 +367,12 @@ public:
         if (!ngeo && !nproxies)
             return GT_PrimitiveHandle();
 
+        // Prime the packed prim bounds caches in one batch. If that was
+        // interrupted, don't go on to compute the rest one at a time.
+        if ((nbox && !GusdGU_PackedUSD::computeBounds(_boxPrims)) ||
+            (ncentroid && !GusdGU_PackedUSD::computeBounds(_centroidPrims)))
+            return GT_PrimitiveHandle();
+
         GT_GEOPrimCollectBoxes          boxdata(_geometry, true);
         UT_StackBuffer<UT_BoundingBox>  boxes(nproxies);
         UT_StackBuffer<UT_Matrix4F>     xforms(nproxies);
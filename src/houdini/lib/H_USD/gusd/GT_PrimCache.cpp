@@ -25,6 +25,7 @@
 #include "GT_PrimCache.h"
 
 #include "GT_PackedUSD.h"
+#include "GT_PrimDiskCache.h"
 #include "primWrapper.h"
 #include "USD_PropertyMap.h"
 #include "USD_StdTraverse.h"
@@ -46,6 +47,7 @@
 #include <SYS/SYS_Version.h>
 #include <UT/UT_HDKVersion.h>
 
+#include <functional>
 #include <iostream>
 
 PXR_NAMESPACE_OPEN_SCOPE
@@ -261,11 +263,15 @@ void
 GusdGT_PrimCache::Clear()
 {
     _prims.clear();
+    GusdGT_PrimDiskCache::GetInstance().ClearModificationTimes();
 }
 
 int64
 GusdGT_PrimCache::Clear(const UT_StringSet& paths)
 {
+    // Layers may have been reloaded.
+    GusdGT_PrimDiskCache::GetInstance().ClearModificationTimes();
+
     return _prims.ClearEntries(
         [&](const UT_CappedKeyHandle& key,
             const UT_CappedItemHandle& item) {
@@ -310,6 +316,9 @@ CreateEntryFn::operator()(
     GT_RefineParms refineParms;
     refineParms.setPackedViewportLOD( true );
 
+    // Key of the on-disk entry for this prim, if it may be cached there.
+    std::string diskKey;
+
     bool isInstance = prim.IsInstance();
     bool isInstanceProxy = prim.IsInstanceProxy();
     if( isInstance || isInstanceProxy)
@@ -332,6 +341,22 @@ CreateEntryFn::operator()(
     {
         UsdGeomImageable imageable( prim );
 
+        // Static gprims may have been refined by an earlier session.
+        const GusdGT_PrimDiskCache& diskCache = 
+            GusdGT_PrimDiskCache::GetInstance();
+        diskKey = diskCache.ComputeKey( prim, purposes );
+        if( !diskKey.empty() ) {
+            if( GT_PrimitiveHandle mesh = diskCache.Load( diskKey )) {
+                DBG( cerr << "Load prim cache for gprim " << prim.GetPath() << " from disk" << endl; )
+                // The key identifies the geometry, so use it for the id.
+                int64 meshId = std::hash<std::string>()( diskKey );
+                UT_Array<GT_PrimitiveHandle> sourceMeshes;
+                sourceMeshes.append( mesh );
+                return new CacheEntry( new GusdGT_PackedUSDMesh( 
+                            mesh, meshId, sourceMeshes ));
+            }
+        }
+
         DBG( cerr << "Create prim cache for gprim " << prim.GetPath() << " at " << time << endl; )
 
         GT_PrimitiveHandle gp = 
@@ -447,8 +472,12 @@ CreateEntryFn::operator()(
             return new CacheEntry( refiner.getPrimCollect()->getPrim( 0 ) );
         }
         else {
+            GT_PrimitiveHandle mesh = refiner.coalescedMeshes(0).result();
+            if( !diskKey.empty() ) {
+                GusdGT_PrimDiskCache::GetInstance().Save( diskKey, mesh );
+            }
             return new CacheEntry( new GusdGT_PackedUSDMesh( 
-                        refiner.coalescedMeshes(0).result(),
+                        mesh,
                         refiner.coalescedIds(0),
                         refiner.sourceMeshes(0)));
         }
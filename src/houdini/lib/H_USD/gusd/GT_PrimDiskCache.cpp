@@ -0,0 +1,488 @@
+//
+// Copyright 2017 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+#include "GT_PrimDiskCache.h"
+
+#include "pxr/base/arch/fileSystem.h"
+#include "pxr/base/arch/systemInfo.h"
+#include "pxr/base/tf/envSetting.h"
+#include "pxr/base/tf/fileUtils.h"
+#include "pxr/base/tf/stringUtils.h"
+#include "pxr/usd/sdf/layer.h"
+#include "pxr/usd/usd/attribute.h"
+#include "pxr/usd/usdGeom/pointBased.h"
+#include "pxr/usd/usdGeom/primvarsAPI.h"
+
+#include <GT/GT_DANumeric.h>
+#include <GT/GT_PrimPolygonMesh.h>
+#include <SYS/SYS_SequentialThreadIndex.h>
+#include <SYS/SYS_Types.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+
+TF_DEFINE_ENV_SETTING(GUSD_GT_PRIMCACHE_DIR, "",
+                      "Directory in which refined viewport meshes of static "
+                      "USD prims are cached across sessions. Leave empty to "
+                      "disable the on-disk cache.");
+
+
+namespace {
+
+
+constexpr char      _Magic[8] = {'G','U','S','D','G','T','C','\0'};
+constexpr uint32    _Version = 1;
+constexpr size_t    _Alignment = 16;
+constexpr size_t    _MaxNameLength = 64;
+
+
+enum _Role
+{
+    ROLE_FACE_COUNTS,
+    ROLE_VERTEX_LIST,
+    ROLE_SHARED,
+    ROLE_VERTEX,
+    ROLE_UNIFORM,
+    ROLE_DETAIL,
+    NUM_ROLES
+};
+
+
+struct _FileHeader
+{
+    char    magic[8];
+    uint32  version;
+    uint32  numArrays;
+    uint64  keyLength;  // Key bytes follow the header, then the descriptors.
+};
+
+
+struct _ArrayDesc
+{
+    int32   role;
+    int32   storage;
+    int32   tupleSize;
+    int32   type;
+    int64   entries;
+    uint64  offset;     // Offset of the data from the start of the file.
+    char    name[_MaxNameLength];
+};
+
+
+size_t
+_Align(size_t n)
+{
+    return (n + _Alignment - 1) & ~(_Alignment - 1);
+}
+
+
+/// Byte size of a single element of @a storage, or 0 if the storage
+/// type can't be written to disk.
+size_t
+_StorageSize(GT_Storage storage)
+{
+    switch(storage) {
+    case GT_STORE_UINT8:    return sizeof(uint8);
+    case GT_STORE_INT32:    return sizeof(int32);
+    case GT_STORE_INT64:    return sizeof(int64);
+    case GT_STORE_REAL16:   return sizeof(fpreal16);
+    case GT_STORE_REAL32:   return sizeof(fpreal32);
+    case GT_STORE_REAL64:   return sizeof(fpreal64);
+    default:                return 0;
+    }
+}
+
+
+const void*
+_GetRawData(const GT_DataArrayHandle& data, GT_DataArrayHandle& buf)
+{
+    switch(data->getStorage()) {
+    case GT_STORE_UINT8:    return data->getU8Array(buf);
+    case GT_STORE_INT32:    return data->getI32Array(buf);
+    case GT_STORE_INT64:    return data->getI64Array(buf);
+    case GT_STORE_REAL16:   return data->getF16Array(buf);
+    case GT_STORE_REAL32:   return data->getF32Array(buf);
+    case GT_STORE_REAL64:   return data->getF64Array(buf);
+    default:                return nullptr;
+    }
+}
+
+
+template <typename T>
+GT_DataArray*
+_CreateArrayT(const void* src, const _ArrayDesc& desc)
+{
+    return new GT_DANumeric<T>(static_cast<const T*>(src), desc.entries,
+                               desc.tupleSize,
+                               static_cast<GT_Type>(desc.type));
+}
+
+
+GT_DataArray*
+_CreateArray(const void* src, const _ArrayDesc& desc)
+{
+    switch(desc.storage) {
+    case GT_STORE_UINT8:    return _CreateArrayT<uint8>(src, desc);
+    case GT_STORE_INT32:    return _CreateArrayT<int32>(src, desc);
+    case GT_STORE_INT64:    return _CreateArrayT<int64>(src, desc);
+    case GT_STORE_REAL16:   return _CreateArrayT<fpreal16>(src, desc);
+    case GT_STORE_REAL32:   return _CreateArrayT<fpreal32>(src, desc);
+    case GT_STORE_REAL64:   return _CreateArrayT<fpreal64>(src, desc);
+    default:                return nullptr;
+    }
+}
+
+
+struct _ArrayToWrite
+{
+    _ArrayDesc          desc;
+    GT_DataArrayHandle  data;
+};
+
+
+bool
+_AddArray(UT_Array<_ArrayToWrite>& arrays, _Role role,
+          const UT_StringHolder& name, const GT_DataArrayHandle& data)
+{
+    if(!data || _StorageSize(data->getStorage()) == 0 ||
+       name.length() >= _MaxNameLength) {
+        return false;
+    }
+    _ArrayToWrite& array = arrays(arrays.append());
+    memset(&array.desc, 0, sizeof(array.desc));
+    array.desc.role = role;
+    array.desc.storage = data->getStorage();
+    array.desc.tupleSize = data->getTupleSize();
+    array.desc.type = data->getTypeInfo();
+    array.desc.entries = data->entries();
+    if(name.isstring())
+        memcpy(array.desc.name, name.c_str(), name.length());
+    array.data = data;
+    return true;
+}
+
+
+bool
+_AddAttributes(UT_Array<_ArrayToWrite>& arrays, _Role role,
+               const GT_AttributeListHandle& attrs)
+{
+    if(!attrs)
+        return true;
+    // Only the first motion segment would be written.
+    if(attrs->getSegments() != 1)
+        return false;
+    for(int i = 0; i < attrs->entries(); ++i) {
+        if(!_AddArray(arrays, role, attrs->getName(i), attrs->get(i)))
+            return false;
+    }
+    return true;
+}
+
+
+} /*namespace*/
+
+
+GusdGT_PrimDiskCache&
+GusdGT_PrimDiskCache::GetInstance()
+{
+    static GusdGT_PrimDiskCache cache;
+    return cache;
+}
+
+
+GusdGT_PrimDiskCache::GusdGT_PrimDiskCache()
+    : _dir(TfGetEnvSetting(GUSD_GT_PRIMCACHE_DIR))
+{
+    if(!_dir.empty() && !TfMakeDirs(_dir, -1, /*existOk*/ true)) {
+        TF_WARN("Unable to create GT prim cache directory '%s'; "
+                "the on-disk cache is disabled.", _dir.c_str());
+        _dir.clear();
+    }
+}
+
+
+std::string
+GusdGT_PrimDiskCache::ComputeKey(const UsdPrim& prim,
+                                 GusdPurposeSet purposes) const
+{
+    if(!IsEnabled() || !prim.IsA<UsdGeomPointBased>())
+        return std::string();
+
+    // Only cache prims that are static, so that one entry serves all times.
+    for(const UsdAttribute& attr : prim.GetAuthoredAttributes()) {
+        if(attr.ValueMightBeTimeVarying())
+            return std::string();
+    }
+    // That includes primvars inherited from ancestors.
+    if(prim.GetParent()) {
+        for(const UsdGeomPrimvar& primvar :
+                UsdGeomPrimvarsAPI(prim.GetParent()).FindInheritablePrimvars()) {
+            if(primvar.ValueMightBeTimeVarying())
+                return std::string();
+        }
+    }
+
+    std::string key = TfStringPrintf("%s\n%d\n",
+                                     prim.GetPath().GetText(),
+                                     static_cast<int>(purposes));
+
+    // Inherited primvars may come from ancestors, so their layers
+    // contribute to the key as well.
+    for(UsdPrim p = prim; p && !p.IsPseudoRoot(); p = p.GetParent()) {
+        if(!_AppendPrimStack(p, key))
+            return std::string();
+    }
+    return key;
+}
+
+
+bool
+GusdGT_PrimDiskCache::_AppendPrimStack(const UsdPrim& prim,
+                                       std::string& key) const
+{
+    for(const SdfPrimSpecHandle& spec : prim.GetPrimStack()) {
+        const SdfLayerHandle layer = spec->GetLayer();
+        if(layer->IsAnonymous() || layer->IsDirty())
+            return false;
+
+        double mtime = 0;
+        if(!_GetModificationTime(layer->GetRealPath(), mtime))
+            return false;
+        key += TfStringPrintf("%s@%.17g:%s\n",
+                              layer->GetIdentifier().c_str(), mtime,
+                              spec->GetPath().GetText());
+    }
+    return true;
+}
+
+
+bool
+GusdGT_PrimDiskCache::_GetModificationTime(const std::string& realPath,
+                                           double& mtime) const
+{
+    if(realPath.empty())
+        return false;
+
+    // Every prim on a layer asks for the same layer, so only stat it once.
+    {
+        UT_AutoReadLock lock(_mtimeLock);
+        const auto it = _mtimes.find(realPath);
+        if(it != _mtimes.end()) {
+            mtime = it->second;
+            return true;
+        }
+    }
+    if(!ArchGetModificationTime(realPath.c_str(), &mtime))
+        return false;
+
+    UT_AutoWriteLock lock(_mtimeLock);
+    _mtimes[realPath] = mtime;
+    return true;
+}
+
+
+void
+GusdGT_PrimDiskCache::ClearModificationTimes()
+{
+    UT_AutoWriteLock lock(_mtimeLock);
+    _mtimes.clear();
+}
+
+
+std::string
+GusdGT_PrimDiskCache::_GetFilePath(const std::string& key) const
+{
+    return TfStringPrintf("%s/%016llx.gtc", _dir.c_str(),
+                          (unsigned long long)std::hash<std::string>()(key));
+}
+
+
+GT_PrimitiveHandle
+GusdGT_PrimDiskCache::Load(const std::string& key) const
+{
+    if(!IsEnabled() || key.empty())
+        return GT_PrimitiveHandle();
+
+    const std::string path = _GetFilePath(key);
+    if(!TfIsFile(path))
+        return GT_PrimitiveHandle();
+
+    ArchConstFileMapping mapping = ArchMapFileReadOnly(path);
+    if(!mapping)
+        return GT_PrimitiveHandle();
+
+    const char* base = mapping.get();
+    const size_t length = ArchGetFileMappingLength(mapping);
+
+    // Validate the header and key. The full key is stored, so hash
+    // collisions are detected here.
+    _FileHeader header;
+    if(length < sizeof(header))
+        return GT_PrimitiveHandle();
+    memcpy(&header, base, sizeof(header));
+    if(memcmp(header.magic, _Magic, sizeof(_Magic)) != 0 ||
+       header.version != _Version ||
+       header.keyLength != key.size()) {
+        return GT_PrimitiveHandle();
+    }
+    const size_t descStart = _Align(sizeof(header) + header.keyLength);
+    if(descStart + header.numArrays*sizeof(_ArrayDesc) > length ||
+       memcmp(base + sizeof(header), key.data(), key.size()) != 0) {
+        return GT_PrimitiveHandle();
+    }
+
+    GT_DataArrayHandle counts, vertexList;
+    GT_AttributeListHandle attrs[NUM_ROLES];
+
+    for(uint32 i = 0; i < header.numArrays; ++i) {
+        _ArrayDesc desc;
+        memcpy(&desc, base + descStart + i*sizeof(desc), sizeof(desc));
+        desc.name[_MaxNameLength-1] = '\0';
+
+        const size_t elemSize = _StorageSize(
+            static_cast<GT_Storage>(desc.storage));
+        const size_t numBytes = elemSize*desc.tupleSize*desc.entries;
+        if(elemSize == 0 || desc.role < 0 || desc.role >= NUM_ROLES ||
+           desc.entries < 0 || desc.tupleSize < 1 ||
+           desc.offset + numBytes > length) {
+            return GT_PrimitiveHandle();
+        }
+
+        GT_DataArrayHandle data(_CreateArray(base + desc.offset, desc));
+        switch(desc.role) {
+        case ROLE_FACE_COUNTS:
+            counts = data;
+            break;
+        case ROLE_VERTEX_LIST:
+            vertexList = data;
+            break;
+        default:
+            if(!attrs[desc.role]) {
+                attrs[desc.role] =
+                    new GT_AttributeList(new GT_AttributeMap());
+            }
+            attrs[desc.role] =
+                attrs[desc.role]->addAttribute(desc.name, data, true);
+            break;
+        }
+    }
+    if(!counts || !vertexList || !attrs[ROLE_SHARED])
+        return GT_PrimitiveHandle();
+
+    return new GT_PrimPolygonMesh(counts, vertexList,
+                                  attrs[ROLE_SHARED], attrs[ROLE_VERTEX],
+                                  attrs[ROLE_UNIFORM], attrs[ROLE_DETAIL]);
+}
+
+
+bool
+GusdGT_PrimDiskCache::Save(const std::string& key,
+                           const GT_PrimitiveHandle& prim) const
+{
+    if(!IsEnabled() || key.empty() || !prim ||
+       prim->getPrimitiveType() != GT_PRIM_POLYGON_MESH) {
+        return false;
+    }
+    const auto* mesh = UTverify_cast<const GT_PrimPolygonMesh*>(prim.get());
+
+    UT_Array<_ArrayToWrite> arrays;
+    if(!_AddArray(arrays, ROLE_FACE_COUNTS, UT_StringHolder(),
+                  mesh->getFaceCounts()) ||
+       !_AddArray(arrays, ROLE_VERTEX_LIST, UT_StringHolder(),
+                  mesh->getVertexList()) ||
+       !_AddAttributes(arrays, ROLE_SHARED, mesh->getShared()) ||
+       !_AddAttributes(arrays, ROLE_VERTEX, mesh->getVertexAttributes()) ||
+       !_AddAttributes(arrays, ROLE_UNIFORM, mesh->getUniformAttributes()) ||
+       !_AddAttributes(arrays, ROLE_DETAIL, mesh->getDetailAttributes())) {
+        return false;
+    }
+
+    _FileHeader header;
+    memcpy(header.magic, _Magic, sizeof(_Magic));
+    header.version = _Version;
+    header.numArrays = arrays.size();
+    header.keyLength = key.size();
+
+    // Lay out the array data after the descriptors.
+    const size_t descStart = _Align(sizeof(header) + key.size());
+    size_t offset = _Align(descStart + arrays.size()*sizeof(_ArrayDesc));
+    for(_ArrayToWrite& array : arrays) {
+        array.desc.offset = offset;
+        offset = _Align(offset +
+                        _StorageSize(array.data->getStorage())*
+                        array.desc.tupleSize*array.desc.entries);
+    }
+
+    // Write to a temporary file and rename it into place, so that
+    // concurrent readers never see a partially written entry. The name
+    // is unique to this thread, since several threads may save the
+    // same key.
+    const std::string path = _GetFilePath(key);
+    const std::string tmpPath =
+        TfStringPrintf("%s.%d.%d.tmp", path.c_str(), ArchGetProcessId(),
+                       static_cast<int>(SYSgetSTID()));
+
+    static const char padding[_Alignment] = {};
+    auto pad = [&](std::ofstream& out) {
+        const size_t pos = out.tellp();
+        out.write(padding, _Align(pos) - pos);
+    };
+
+    {
+        std::ofstream out(tmpPath, std::ios::binary|std::ios::trunc);
+        if(!out)
+            return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(key.data(), key.size());
+        pad(out);
+        for(const _ArrayToWrite& array : arrays) {
+            out.write(reinterpret_cast<const char*>(&array.desc),
+                      sizeof(array.desc));
+        }
+        for(const _ArrayToWrite& array : arrays) {
+            pad(out);
+            GT_DataArrayHandle buf;
+            const void* data = _GetRawData(array.data, buf);
+            out.write(static_cast<const char*>(data),
+                      _StorageSize(array.data->getStorage())*
+                      array.desc.tupleSize*array.desc.entries);
+        }
+        if(!out) {
+            out.close();
+            TfDeleteFile(tmpPath);
+            return false;
+        }
+    }
+    if(std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        TfDeleteFile(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,115 @@
+//
+// Copyright 2017 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+#ifndef __GUSD_GT_PRIMDISKCACHE_H__
+#define __GUSD_GT_PRIMDISKCACHE_H__
+
+#include "gusd/api.h"
+
+#include "purpose.h"
+
+#include <GT/GT_Primitive.h>
+#include <UT/UT_RWLock.h>
+#include <UT/UT_StringHolder.h>
+#include <UT/UT_StringMap.h>
+
+#include "pxr/pxr.h"
+#include "pxr/usd/usd/prim.h"
+
+#include <string>
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+/// Optional on-disk second tier for GusdGT_PrimCache.
+//
+// Refined polygon meshes of static gprims are written to a cache directory,
+// so that later sessions (or other farm tasks sharing the directory) can
+// skip both reading the USD attributes and refining them.
+//
+// Entries are keyed by the prim path, the purposes, and the identity and
+// modification time of every layer contributing to the prim. Only prims
+// whose authored attributes and inherited primvars are all time-invariant
+// are cached, so that a single entry serves every frame. Prims contributed to by anonymous or
+// dirty layers are never cached.
+//
+// Each entry is a single file, laid out so that it can be memory mapped:
+// a header holding the full key, a table of array descriptors, and the
+// raw array data, with each array aligned to 16 bytes.
+//
+// The cache is enabled by setting GUSD_GT_PRIMCACHE_DIR to a directory.
+
+class GusdGT_PrimDiskCache
+{
+public:
+
+    GUSD_API
+    static GusdGT_PrimDiskCache& GetInstance();
+
+    GusdGT_PrimDiskCache();
+
+    bool                IsEnabled() const   { return !_dir.empty(); }
+
+    const std::string&  GetDirectory() const    { return _dir; }
+
+    /// Return the cache key for @a prim, or an empty string if the prim
+    /// should not be cached on disk.
+    GUSD_API
+    std::string         ComputeKey(const UsdPrim& prim,
+                                   GusdPurposeSet purposes) const;
+
+    /// Load the polygon mesh stored under @a key, if any.
+    GUSD_API
+    GT_PrimitiveHandle  Load(const std::string& key) const;
+
+    /// Store a refined polygon mesh under @a key.
+    /// Meshes holding non-numeric or motion blurred attributes are skipped.
+    /// Returns true if the mesh was written.
+    GUSD_API
+    bool                Save(const std::string& key,
+                             const GT_PrimitiveHandle& mesh) const;
+
+    /// Forget the layer modification times gathered by ComputeKey().
+    /// These are read once per layer, and should be cleared whenever
+    /// layers may have been reloaded.
+    GUSD_API
+    void                ClearModificationTimes();
+
+private:
+    std::string         _GetFilePath(const std::string& key) const;
+
+    /// Append the contributing layers of @a prim to @a key.
+    /// Returns false if any of those layers can't be identified on disk.
+    bool                _AppendPrimStack(const UsdPrim& prim,
+                                         std::string& key) const;
+
+    bool                _GetModificationTime(const std::string& realPath,
+                                             double& mtime) const;
+
+    std::string                 _dir;
+    mutable UT_StringMap<double> _mtimes;
+    mutable UT_RWLock           _mtimeLock;
+};
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif // __GUSD_GT_PRIMDISKCACHE_H__
@@ -0,0 +1,85 @@
+//
+// Copyright 2017 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+#include "gusd/GT_ReverseWindingArray.h"
+
+#include <GT/GT_DANumeric.h>
+
+#include <algorithm>
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+GusdGT_ReverseWindingArray::GusdGT_ReverseWindingArray(
+    const GT_DataArrayHandle& faceCounts)
+    : _uniformCount(0), _size(0)
+{
+    const GT_Size numFaces = faceCounts ? faceCounts->entries() : 0;
+    if(numFaces == 0)
+        return;
+
+    GT_DataArrayHandle buffer;
+    const int32* counts = faceCounts->getI32Array(buffer);
+
+    // Meshes made entirely of triangles or quads are common, and need
+    // no per-face storage at all.
+    const bool isUniform =
+        counts[0] > 0 &&
+        std::all_of(counts, counts + numFaces,
+                    [&](int32 n) { return n == counts[0]; });
+    if(isUniform) {
+        _uniformCount = counts[0];
+        _size = _uniformCount*numFaces;
+        return;
+    }
+
+    _faceOffsets.setSizeNoInit(numFaces+1);
+    GT_Offset offset = 0;
+    for(GT_Size f = 0; f < numFaces; ++f) {
+        _faceOffsets(f) = offset;
+        offset += SYSmax(counts[f], 0);
+    }
+    _faceOffsets(numFaces) = offset;
+    _size = offset;
+}
+
+
+GT_Offset
+GusdGT_ReverseWindingArray::_FindFace(GT_Offset o) const
+{
+    // Last face whose first vertex is at or before o. Empty faces share
+    // their offset with the following face, so upper_bound skips them.
+    const GT_Offset* begin = _faceOffsets.data();
+    const GT_Offset* end = begin + _faceOffsets.size() - 1;
+    return (std::upper_bound(begin, end, o) - begin) - 1;
+}
+
+
+GT_DataArrayHandle
+GusdGT_ReverseWindingArray::harden() const
+{
+    auto* indices = new GT_Int32Array(_size, 1);
+    _FillArrayT(indices->data(), 0, _size, 1);
+    return GT_DataArrayHandle(indices);
+}
+
+PXR_NAMESPACE_CLOSE_SCOPE
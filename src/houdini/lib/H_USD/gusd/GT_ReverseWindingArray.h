@@ -0,0 +1,182 @@
+//
+// Copyright 2017 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+#ifndef _GUSD_GT_REVERSEWINDINGARRAY_H_
+#define _GUSD_GT_REVERSEWINDINGARRAY_H_
+
+#include "gusd/api.h"
+
+#include <GT/GT_DataArray.h>
+#include <UT/UT_Array.h>
+
+#include "pxr/pxr.h"
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+/// Lazily evaluated index array that reverses the winding order of
+/// each face of a polygon mesh.
+///
+/// Element @c i holds the face-vertex that should be read in place of
+/// face-vertex @c i once the winding order of its face is reversed. The
+/// first vertex of each face is kept in place, matching Houdini's own
+/// reversal. Only the face offsets are stored, so wrapping the USD face
+/// indices, or a mesh's vertex attributes, in a GT_DAIndirect with this
+/// array avoids copying them.
+/// Example:
+/// \code
+///     GT_DataArrayHandle reversal(
+///         new GusdGT_ReverseWindingArray(faceCounts));
+///     GT_DataArrayHandle indices(new GT_DAIndirect(reversal, usdIndices));
+/// \endcode
+///
+/// A full index array is only materialized by harden(), or when a
+/// consumer requests a raw array of a different storage type.
+class GusdGT_ReverseWindingArray : public GT_DataArray
+{
+public:
+    GUSD_API
+    GusdGT_ReverseWindingArray(const GT_DataArrayHandle& faceCounts);
+
+    ~GusdGT_ReverseWindingArray() override = default;
+
+    const char*         className() const override
+                        { return "GusdGT_ReverseWindingArray"; }
+
+    /// Return the reversed face-vertex for face-vertex @a o.
+    SYS_FORCE_INLINE
+    GT_Offset           operator()(GT_Offset o) const
+                        {
+                            UT_ASSERT_P(o >= 0 && o < _size);
+                            GT_Offset base, count;
+                            if(_uniformCount > 0) {
+                                count = _uniformCount;
+                                base = (o/count)*count;
+                            } else {
+                                const GT_Offset face = _FindFace(o);
+                                base = _faceOffsets(face);
+                                count = _faceOffsets(face+1) - base;
+                            }
+                            const GT_Offset p = o - base;
+                            return p == 0 ? o : base + count - p;
+                        }
+
+    GUSD_API
+    GT_DataArrayHandle  harden() const override;
+
+    GT_Storage          getStorage() const override { return GT_STORE_INT32; }
+    GT_Size             getTupleSize() const override   { return 1; }
+    GT_Size             entries() const override        { return _size; }
+    GT_Type             getTypeInfo() const override
+                        { return GT_TYPE_NONE; }
+    int64               getMemoryUsage() const override
+                        { return sizeof(*this) +
+                                 _faceOffsets.getMemoryUsage(false); }
+
+    uint8               getU8(GT_Offset o, int idx=0) const override
+                        { return (*this)(o); }
+    int32               getI32(GT_Offset o, int idx=0) const override
+                        { return (*this)(o); }
+    int64               getI64(GT_Offset o, int idx=0) const override
+                        { return (*this)(o); }
+    fpreal32            getF32(GT_Offset o, int idx=0) const override
+                        { return (*this)(o); }
+    fpreal64            getF64(GT_Offset o, int idx=0) const override
+                        { return (*this)(o); }
+
+protected:
+    using GT_DataArray::doFillArray;
+
+    void                doFillArray(int32* dst, GT_Offset start,
+                                    GT_Size length, int tsize,
+                                    int stride) const override
+                        { _FillArrayT(dst, start, length, stride); }
+
+    void                doFillArray(int64* dst, GT_Offset start,
+                                    GT_Size length, int tsize,
+                                    int stride) const override
+                        { _FillArrayT(dst, start, length, stride); }
+
+private:
+    GUSD_API
+    GT_Offset           _FindFace(GT_Offset o) const;
+
+    /// Fill sequentially, walking faces rather than searching per element.
+    template <typename PODT>
+    void                _FillArrayT(PODT* dst, GT_Offset start,
+                                    GT_Size length, int stride) const;
+
+    // No string support.
+    GT_String           getS(GT_Offset, int) const override
+                        { return nullptr; }
+    GT_Size             getStringIndexCount() const override
+                        { return -1; }
+    GT_Offset           getStringIndex(GT_Offset, int) const override
+                        { return -1; }
+    void                getIndexedStrings(UT_StringArray&,
+                                          UT_IntArray&) const override {}
+
+private:
+    /// Offset of the first vertex of each face, plus a trailing entry
+    /// holding the vertex count. Empty if all faces share a vertex count.
+    UT_Array<GT_Offset> _faceOffsets;
+    GT_Offset           _uniformCount;
+    GT_Size             _size;
+};
+
+
+template <typename PODT>
+void
+GusdGT_ReverseWindingArray::_FillArrayT(PODT* dst, GT_Offset start,
+                                        GT_Size length, int stride) const
+{
+    if(length <= 0)
+        return;
+    stride = SYSmax(stride, 1);
+
+    const GT_Offset end = start + length;
+    GT_Offset o = start;
+    if(_uniformCount > 0) {
+        for(GT_Offset base = (start/_uniformCount)*_uniformCount;
+            o < end; base += _uniformCount) {
+            const GT_Offset faceEnd = SYSmin(base + _uniformCount, end);
+            for( ; o < faceEnd; ++o, dst += stride) {
+                const GT_Offset p = o - base;
+                *dst = static_cast<PODT>(p == 0 ? o : base+_uniformCount-p);
+            }
+        }
+        return;
+    }
+    for(GT_Offset face = _FindFace(start); o < end; ++face) {
+        const GT_Offset base = _faceOffsets(face);
+        const GT_Offset count = _faceOffsets(face+1) - base;
+        const GT_Offset faceEnd = SYSmin(base + count, end);
+        for( ; o < faceEnd; ++o, dst += stride) {
+            const GT_Offset p = o - base;
+            *dst = static_cast<PODT>(p == 0 ? o : base + count - p);
+        }
+    }
+}
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif /*_GUSD_GT_REVERSEWINDINGARRAY_H_*/
@@ -164,32 +164,32 @@ GusdGT_VtStringArray<T>::harden() const
 
 
 template <>
-GT_String
+inline GT_String
 GusdGT_VtStringArray<std::string>::_GetString(const std::string& o) const
 { return _GetStringFromStdString(o); }
 
 
 template <>
-GT_String
+inline GT_String
 GusdGT_VtStringArray<TfToken>::_GetString(const TfToken& o) const
 { return _GetStringFromStdString(o.GetString()); }
 
 
 template <>
-GT_String
+inline GT_String
 GusdGT_VtStringArray<SdfPath>::_GetString(const SdfPath& o) const
 { return _GetStringFromStdString(o.GetString()); }
 
 
 template <>
-GT_String
+inline GT_String
 GusdGT_VtStringArray<SdfAssetPath>::_GetString(const SdfAssetPath& o) const
 { return _GetStringFromStdString(o.GetAssetPath()); }
 
 
 
 template <>
-int64
+inline int64
 GusdGT_VtStringArray<std::string>::getMemoryUsage() const
 {
     int64 sz = sizeof(*this) + sizeof(ValueType)*_size;
@@ -200,7 +200,7 @@ GusdGT_VtStringArray<std::string>::getMemoryUsage() const
 
 
 template <>
-int64
+inline int64
 GusdGT_VtStringArray<SdfAssetPath>::getMemoryUsage() const
 {
     int64 sz = sizeof(*this) + sizeof(ValueType)*_size;
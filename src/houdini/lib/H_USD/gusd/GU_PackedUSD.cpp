@@ -53,6 +53,7 @@
 #include "pxr/base/tf/stringUtils.h"
 
 #include <GA/GA_AttributeFilter.h>
+#include <GA/GA_Iterator.h>
 #include <GA/GA_SaveMap.h>
 #include <GT/GT_PrimInstance.h>
 #include <GT/GT_GEODetail.h>
@@ -66,8 +67,11 @@
 #include <GU/GU_PackedFactory.h>
 #include <GU/GU_PrimPacked.h>
 #include <UT/UT_DMatrix4.h>
+#include <UT/UT_Interrupt.h>
 #include <UT/UT_Map.h>
+#include <UT/UT_ParallelUtil.h>
 
+#include <algorithm>
 #include <mutex>
 #include <iostream>
 
@@ -671,6 +675,139 @@ GusdGU_PackedUSD::getBounds(UT_BoundingBox &box) const
     return false;
 }
 
+/* static */
+bool
+GusdGU_PackedUSD::computeBounds(const GA_Detail &gdp, const GA_Range &range)
+{
+    UT_Array<const GU_PrimPacked *> prims;
+    prims.setCapacity(range.getEntries());
+
+    const GA_PrimitiveTypeId packedUsdType = typeId();
+    for( GA_Iterator it(range); !it.atEnd(); ++it )
+    {
+        const GA_Primitive *prim = gdp.getPrimitive(*it);
+        if( prim && prim->getTypeId() == packedUsdType )
+            prims.append(UTverify_cast<const GU_PrimPacked *>(prim));
+    }
+    return computeBounds(prims);
+}
+
+/* static */
+bool
+GusdGU_PackedUSD::computeBounds(const UT_Array<const GU_PrimPacked *> &prims)
+{
+    const exint n = prims.size();
+    if( n == 0 )
+        return true;
+
+    struct _Entry
+    {
+        const GusdGU_PackedUSD *impl;
+        UsdPrim                 prim;
+    };
+
+    // Skip prims whose bounds are already in GU_PackedImpl's box cache.
+    // Resolve the others on this thread so that stage load errors are
+    // reported on the caller's error manager. Repeated stages are cache
+    // hits.
+    UT_Array<_Entry> entries;
+    entries.setCapacity(n);
+    for( const GU_PrimPacked *packed : prims )
+    {
+        auto impl = UTverify_cast<const GusdGU_PackedUSD *>(
+                packed->implementation());
+        if( impl->myBoxCache.isValid() )
+            continue;
+
+        UsdPrim prim = impl->getUsdPrim();
+        if( prim && !prim.IsA<UsdGeomImageable>() )
+            prim = UsdPrim();
+        entries.append({ impl, prim });
+    }
+
+    const exint nentries = entries.size();
+    if( nentries == 0 )
+        return true;
+
+    // Group entries that can share a bounds cache entry.
+    UT_Array<exint> order;
+    order.setSizeNoInit(nentries);
+    for( exint i = 0; i < nentries; ++i )
+        order[i] = i;
+
+    auto stageOf = [&](exint i) {
+        return entries(i).prim ? get_pointer(entries(i).prim.GetStage())
+                               : nullptr;
+    };
+    std::stable_sort(order.begin(), order.end(),
+        [&](exint a, exint b) {
+            const UsdStage *sa = stageOf(a);
+            const UsdStage *sb = stageOf(b);
+            if( sa != sb )
+                return sa < sb;
+            const GusdGU_PackedUSD *ia = entries(a).impl;
+            const GusdGU_PackedUSD *ib = entries(b).impl;
+            if( ia->m_purposes != ib->m_purposes )
+                return ia->m_purposes < ib->m_purposes;
+            return ia->m_frame < ib->m_frame;
+        });
+
+    UT_Array<exint> groupStarts;
+    for( exint i = 0; i < nentries; ++i )
+    {
+        if( i == 0 )
+        {
+            groupStarts.append(i);
+            continue;
+        }
+        const exint a = order(i-1), b = order(i);
+        if( stageOf(a) != stageOf(b) ||
+            entries(a).impl->m_purposes != entries(b).impl->m_purposes ||
+            entries(a).impl->m_frame != entries(b).impl->m_frame )
+        {
+            groupStarts.append(i);
+        }
+    }
+    groupStarts.append(nentries);
+
+    UT_Array<UT_BoundingBox> boxes;
+    boxes.setSizeNoInit(nentries);
+
+    UTparallelForEachNumber(groupStarts.size() - 1,
+        [&](const UT_BlockedRange<exint> &r)
+        {
+            for( exint g = r.begin(); g < r.end(); ++g )
+            {
+                const exint start = groupStarts(g);
+                const exint end = groupStarts(g+1);
+                const GusdGU_PackedUSD *first = entries(order(start)).impl;
+
+                UT_Array<UsdPrim> groupPrims;
+                groupPrims.setCapacity(end - start);
+                for( exint i = start; i < end; ++i )
+                    groupPrims.append(entries(order(i)).prim);
+
+                GusdBoundsCache::GetInstance().ComputeUntransformedBounds(
+                    groupPrims,
+                    first->m_frame,
+                    GusdPurposeSetToTokens(first->m_purposes),
+                    boxes.data() + start);
+            }
+        });
+
+    if( UTgetInterrupt()->opInterrupt() )
+        return false;
+
+    // Boxes were computed in group order; scatter them back to the prims.
+    for( exint i = 0; i < nentries; ++i )
+    {
+        // The box cache is mutable, as getBoundsCached() fills it in from
+        // a const prim too.
+        entries(order(i)).impl->myBoxCache = boxes(i);
+    }
+    return true;
+}
+
 bool
 GusdGU_PackedUSD::getRenderingBounds(UT_BoundingBox &box) const
 {
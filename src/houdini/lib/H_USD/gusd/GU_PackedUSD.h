@@ -26,6 +26,7 @@
 #define __GUSD_GU_PACKEDIMPL_H__
 
 
+#include <GA/GA_Range.h>
 #include <GU/GU_PackedImpl.h>
 #include <GT/GT_Handles.h>
 #include <SYS/SYS_Version.h>
@@ -201,6 +202,16 @@ public:
         const UT_Options &options) override;
 
     virtual bool     getBounds(UT_BoundingBox &box) const override;
+
+    /// Compute the bounds of all packed USD prims in \p range in one
+    /// parallel pass and store them in each prim's bounds cache, so that
+    /// subsequent getBoundsCached() calls are free. Prims are grouped by
+    /// stage, time and purposes so each group shares a bounds cache entry.
+    /// Returns false if the operation was interrupted.
+    static bool      computeBounds(const GA_Detail &gdp,
+                                   const GA_Range &range);
+    static bool      computeBounds(
+                        const UT_Array<const GU_PrimPacked *> &prims);
     virtual bool     getRenderingBounds(UT_BoundingBox &box) const override;
     virtual void     getVelocityRange(UT_Vector3 &min, UT_Vector3 &max) const override;
     virtual void     getWidthRange(fpreal &min, fpreal &max) const override;
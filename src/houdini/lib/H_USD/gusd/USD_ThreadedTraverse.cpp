@@ -30,82 +30,62 @@ PXR_NAMESPACE_OPEN_SCOPE
 namespace GusdUSD_ThreadedTraverse {
 
 
-TaskData::~TaskData()
-{
-    for(auto it = threadData.begin(); it != threadData.end(); ++it) {
-        if(auto* tdata = it.get())
-            delete tdata;
-    }
-}
+namespace {
 
 
+template <typename T, typename ConvertFn>
 bool
-TaskData::GatherPrimsFromThreads(
-    UT_Array<GusdUSD_Traverse::PrimIndexPair>& prims)
+_GatherPrimsFromSlotsT(const UT_Array<TraverseSlot>& slots,
+                       UT_Array<T>& prims, const ConvertFn& convertFn)
 {
     prims.clear();
-        
-    /* Compute the full prim count & pre-allocate space.*/
-    exint nPrims = 0;
-    for(auto it = threadData.begin(); it != threadData.end(); ++it) {
-        if(const auto* tdata = it.get())
-            nPrims += tdata->prims.size();
-    }
-    prims.setCapacity(nPrims);
 
-    /* Concat the per-thread arrays.*/
-    for(auto it = threadData.begin(); it != threadData.end(); ++it) {
-        if(const auto* tdata = it.get())
-            prims.concat(tdata->prims);
+    // Slots are already in traversal order, so just concatenate them.
+    // Each slot gets its start offset first, so the copy can be parallel.
+    UT_Array<exint> offsets;
+    offsets.setSizeNoInit(slots.size()+1);
+    exint nPrims = 0;
+    for(exint i = 0; i < slots.size(); ++i) {
+        offsets(i) = nPrims;
+        nPrims += slots(i).size();
     }
+    offsets(slots.size()) = nPrims;
 
-    /* The ordering of prims coming directly from different threads
-       will be non-deterministic. Sort them to make our results deterministic.*/
-    UTparallelStableSort<
-        UT_Array<GusdUSD_Traverse::PrimIndexPair>::iterator>(
-        prims.begin(), prims.end(),
-        [](const GusdUSD_Traverse::PrimIndexPair& lhs,
-           const GusdUSD_Traverse::PrimIndexPair& rhs)
+    prims.setSize(nPrims);
+    UTparallelForEachNumber(slots.size(),
+        [&](const UT_BlockedRange<exint>& r)
         {
-            return lhs.second < rhs.second ||
-                   (lhs.second == rhs.second &&
-                    lhs.first.GetPath() < rhs.first.GetPath());
+            for(exint i = r.begin(); i < r.end(); ++i) {
+                const TraverseSlot& slot = slots(i);
+                for(exint j = 0; j < slot.size(); ++j)
+                    prims(offsets(i) + j) = convertFn(slot(j));
+            }
         });
     return !UTgetInterrupt()->opInterrupt();
 }
 
 
+} /*namespace*/
+
+
 bool
-TaskData::GatherPrimsFromThreads(UT_Array<UsdPrim>& prims)
+GatherPrimsFromSlots(const UT_Array<TraverseSlot>& slots,
+                     UT_Array<GusdUSD_Traverse::PrimIndexPair>& prims)
 {
-    prims.clear();
-        
-    /* Compute the full prim count */
-    exint nPrims = 0;
-    for(auto it = threadData.begin(); it != threadData.end(); ++it) {
-        if(const auto* tdata = it.get())
-            nPrims += tdata->prims.size();
-    }
-        
-    /* Pre-allocate all the space we need */
-    prims.setCapacity(nPrims);
-
-    /* Concat the per-thread arrays.*/
-    for(auto it = threadData.begin(); it != threadData.end(); ++it) {
-        if(const auto* tdata = it.get()) {
-            /* Entries are stored in threads as (prim,index) pairs,
-               so need to pull the prims separately.*/
-            exint start = prims.size();
-            exint count = tdata->prims.size();
-            prims.setSize(start + count);
-            for(exint i = 0; i < count; ++i)
-                prims(start + i) = tdata->prims(i).first;
-        }
-    }
+    return _GatherPrimsFromSlotsT(
+        slots, prims,
+        [](const GusdUSD_Traverse::PrimIndexPair& pair) { return pair; });
+}
+
 
-    /* The ordering of prims coming directly from different threads
-       will be non-deterministic. Sort them to make our results deterministic.*/
-    return GusdUSD_Utils::SortPrims(prims);
+bool
+GatherPrimsFromSlots(const UT_Array<TraverseSlot>& slots,
+                     UT_Array<UsdPrim>& prims)
+{
+    return _GatherPrimsFromSlotsT(
+        slots, prims,
+        [](const GusdUSD_Traverse::PrimIndexPair& pair)
+        { return pair.first; });
 }
 
 
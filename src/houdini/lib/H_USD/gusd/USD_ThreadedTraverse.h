@@ -28,8 +28,8 @@
 #include <UT/UT_Array.h>
 #include <UT/UT_Interrupt.h>
 #include <UT/UT_ParallelUtil.h>
-#include <UT/UT_Task.h>
-#include <UT/UT_ThreadSpecificValue.h>
+#include <UT/UT_Thread.h>
+#include <SYS/SYS_Math.h>
 
 #include "gusd/UT_Assert.h"
 #include "gusd/USD_Traverse.h"
@@ -40,6 +40,8 @@
 #include "pxr/usd/usd/prim.h"
 #include "pxr/usd/usdGeom/imageable.h"
 
+#include <iterator>
+
 PXR_NAMESPACE_OPEN_SCOPE
 
 namespace GusdUSD_ThreadedTraverse {
@@ -107,183 +109,272 @@ DefaultImageablePrimVisitorT<Visitor,Recursive>::AcceptPrim(
 }
 
 
-struct TaskThreadData
-{
-    UT_Array<GusdUSD_Traverse::PrimIndexPair>   prims;
-};
-
-typedef UT_ThreadSpecificValue<TaskThreadData*> TaskThreadDataTLS;
-
+/** Matches of a single chunk of a parallel traversal.
+    Chunks are held in DFS order, and each writes its matches into its own
+    slot, so concatenating the slots gives a deterministic result without
+    having to sort.*/
+typedef UT_Array<GusdUSD_Traverse::PrimIndexPair> TraverseSlot;
 
-struct TaskData
-{
-    ~TaskData();
+/** Concatenate the slots of a traversal, in order.*/
+bool    GatherPrimsFromSlots(const UT_Array<TraverseSlot>& slots,
+                             UT_Array<UsdPrim>& prims);
 
-    TaskThreadDataTLS   threadData;
+bool    GatherPrimsFromSlots(
+            const UT_Array<TraverseSlot>& slots,
+            UT_Array<GusdUSD_Traverse::PrimIndexPair>& prims);
 
-    /** Collect all of the prims from the numerous threads.
-        The resulting prims are sorted (for determinism) */
-    bool    GatherPrimsFromThreads(UT_Array<UsdPrim>& prims);
 
-    bool    GatherPrimsFromThreads(
-                UT_Array<GusdUSD_Traverse::PrimIndexPair>& prims);
-};
+/** Parallel traversal of one or more prim trees.
 
+    Rather than spawning a task per prim, the hierarchy is first split into
+    chunks, each holding a run of sibling prims: starting from the roots,
+    chunks whose prims have children are replaced by their children, a
+    level at a time, until there are enough chunks to keep all threads
+    busy. Children are grouped into runs by their count, so that prims
+    with many children don't produce a chunk per child. Each chunk is
+    then traversed serially, depth-first, so small subtrees carry no
+    scheduling overhead.
 
-/** Task for traversing a prim tree in parallel.
+    Visitors may carry state inherited down the hierarchy, so each prim
+    is visited with its own copy of the visitor of its parent.
 
     See DefaultImageablePrimVisitorT<> for an example of the structure
     expected for visitors. */
 template <class Visitor>
-struct TraverseTaskT : public UT_Task
+class ChunkedTraverseT
 {
-    TraverseTaskT(const UsdPrim& prim,  exint idx, UsdTimeCode time,
-                  GusdPurposeSet purposes,
-                  TaskData& data, const Visitor& visitor, bool skipPrim)
-        :  UT_Task(), _prim(prim), _idx(idx), _time(time),
-           _purposes(purposes), _data(data),
-           _visited(false), _visitor(visitor), _skipPrim(skipPrim) {}
+public:
+    /// Number of chunks to aim for per thread. Over-splitting lets
+    /// threads that finish small subtrees early pick up more work.
+    static const exint  CHUNKS_PER_THREAD = 8;
 
-    virtual UT_Task*    run();
+    ChunkedTraverseT(const Visitor& visitor)
+        : _visitor(visitor) {}
+
+    void    AddRoot(const UsdPrim& root, exint idx, UsdTimeCode time,
+                    GusdPurposeSet purposes, bool skipRoot);
+
+    /** Run the traversal. Returns false if interrupted.*/
+    bool    Run();
+
+    const UT_Array<TraverseSlot>&   GetSlots() const    { return _slots; }
 
 private:
-    UsdPrim         _prim;
-    exint           _idx;
-    UsdTimeCode     _time;
-    GusdPurposeSet  _purposes;
-    TaskData&       _data;
-    bool            _visited;
-    Visitor         _visitor;
-    bool            _skipPrim;
+    /** A unit of work: a run of @a count sibling prims, starting at
+        @a prim.*/
+    struct _Chunk
+    {
+        UsdPrim         prim;
+        exint           count;
+        exint           idx;
+        UsdTimeCode     time;
+        GusdPurposeSet  purposes;
+        Visitor         visitor;        /// State after visiting the parent.
+        bool            visitPrim;      /// Pass the prims to the visitor.
+        bool            visitChildren;  /// Traverse beneath the prims.
+    };
+
+    /** Pass @a prim to @a visitor, recording a match in @a slot.
+        Returns true if the prim's children should be traversed.*/
+    static bool _Visit(const _Chunk& chunk, Visitor& visitor,
+                       const UsdPrim& prim, TraverseSlot& slot);
+
+    void    _Split();
+
+    void    _TraverseSerial(const _Chunk& chunk, const UsdPrim& prim,
+                            bool visitPrim, Visitor visitor,
+                            TraverseSlot& slot, UT_Interrupt* boss,
+                            exint& counter) const;
+
+    UT_Array<_Chunk>        _chunks;
+    UT_Array<TraverseSlot>  _slots;
+    const Visitor           _visitor;
 };
 
 
-/** XXX: This parallel recursion pattern follows the
-    'Recycling Parent as Continuation' pattern from
-    TBB's 'Catalog of Recommend task Patterns' */
 template <class Visitor>
-UT_Task*
-TraverseTaskT<Visitor>::run()
+void
+ChunkedTraverseT<Visitor>::AddRoot(const UsdPrim& root, exint idx,
+                                   UsdTimeCode time, GusdPurposeSet purposes,
+                                   bool skipRoot)
 {
-    /* XXX: Ended up needing this check at some point.
-            Find out if it's still necessary.*/
-    if(ARCH_UNLIKELY(_visited)) return NULL;
-    _visited = true;
-
-    UT_ASSERT_P(_prim);
-
-    if(!_skipPrim) {
-
-        GusdUSD_TraverseControl ctl;
-        if(ARCH_UNLIKELY(_visitor.AcceptPrim(_prim, _time, _purposes, ctl))) {
-            /* Matched. Add it to the thread-specific list.*/
-            auto*& threadData = _data.threadData.get();
-            if(!threadData)
-                threadData = new TaskThreadData;
-            threadData->prims.append(
-                GusdUSD_Traverse::PrimIndexPair(_prim, _idx));
-        }
-        if(ARCH_UNLIKELY(!ctl.GetVisitChildren())) {
-            return NULL;
-        }
+    const bool skipPrim =
+        skipRoot || root.GetPath() == SdfPath::AbsoluteRootPath();
+    _chunks.append(_Chunk{root, 1, idx, time, purposes, _visitor,
+                          !skipPrim, /*visit children*/ true});
+    _slots.append();
+}
+
+
+template <class Visitor>
+bool
+ChunkedTraverseT<Visitor>::_Visit(const _Chunk& chunk,
+                                  Visitor& visitor,
+                                  const UsdPrim& prim,
+                                  TraverseSlot& slot)
+{
+    GusdUSD_TraverseControl ctl;
+    if(ARCH_UNLIKELY(visitor.AcceptPrim(prim, chunk.time,
+                                        chunk.purposes, ctl))) {
+        slot.append(GusdUSD_Traverse::PrimIndexPair(prim, chunk.idx));
     }
+    return ctl.GetVisitChildren();
+}
+
+
+template <class Visitor>
+void
+ChunkedTraverseT<Visitor>::_Split()
+{
+    const exint target = UT_Thread::getNumProcessors()*CHUNKS_PER_THREAD;
+    const auto predicate = _visitor.TraversalPredicate();
+
+    while(_chunks.size() < target) {
+        UT_Array<_Chunk> chunks;
+        UT_Array<TraverseSlot> slots;
+        chunks.setCapacity(_chunks.size());
+        slots.setCapacity(_slots.size());
+        bool expanded = false;
+
+        for(exint i = 0; i < _chunks.size(); ++i) {
+            _Chunk& chunk = _chunks(i);
+            TraverseSlot& slot = _slots(i);
+
+            // Stop expanding once there are enough chunks.
+            if(!chunk.visitChildren ||
+               chunks.size() + _chunks.size() - i >= target) {
+                chunks.append(std::move(chunk));
+                slots.append(std::move(slot));
+                continue;
+            }
+
+            UsdPrim prim = chunk.prim;
+            for(exint n = 0; n < chunk.count; ++n) {
+                if(n > 0)
+                    prim = prim.GetFilteredNextSibling(predicate);
+
+                // Visit the prim now, so that its children can be split
+                // off. Its own match (if any) stays in a slot ahead of
+                // theirs.
+                Visitor visitor(chunk.visitor);
+                TraverseSlot primSlot;
+                const bool visitChildren = !chunk.visitPrim ||
+                    _Visit(chunk, visitor, prim, primSlot);
+                if(!primSlot.isEmpty()) {
+                    chunks.append(_Chunk{prim, 1, chunk.idx, chunk.time,
+                                         chunk.purposes, visitor,
+                                         false, false});
+                    slots.append(std::move(primSlot));
+                }
+                if(!visitChildren)
+                    continue;
+
+                const auto children = prim.GetFilteredChildren(predicate);
+                const exint numChildren =
+                    std::distance(children.begin(), children.end());
+                if(numChildren == 0)
+                    continue;
+
+                // Spread the children over the chunks still wanted.
+                const exint wanted = SYSmax(
+                    target - chunks.size() - (_chunks.size() - i - 1),
+                    exint(1));
+                const exint runLength = (numChildren + wanted - 1)/wanted;
+
+                auto it = children.begin();
+                for(exint left = numChildren; left > 0; ) {
+                    const exint count = SYSmin(runLength, left);
+                    chunks.append(_Chunk{*it, count, chunk.idx, chunk.time,
+                                         chunk.purposes, visitor,
+                                         true, true});
+                    slots.append();
+                    std::advance(it, count);
+                    left -= count;
+                    expanded = true;
+                }
+            }
+        }
+        _chunks = std::move(chunks);
+        _slots = std::move(slots);
 
-    /* Count the children so we can increment the ref count accordingly.*/
-    int count = 0;
-    auto children = _prim.GetFilteredChildren(_visitor.TraversalPredicate());
-    for (auto i = children.begin(); i != children.end(); ++i, ++count) {}
-
-    if(count == 0)
-        return NULL;
-
-    setRefCount(count);
-    recycleAsContinuation();
-
-    const int last = count - 1;
-    int idx = 0;
-    for (const auto& child : 
-          _prim.GetFilteredChildren(_visitor.TraversalPredicate())) {
-        auto& task =
-            *new(allocate_child()) TraverseTaskT(child, _idx, _time, 
-                                                 _purposes, _data,
-                                                 _visitor, /*skip prim*/ false);
-        if(idx == last)
-            return &task;
-        else
-            spawnChild(task);
-        ++idx;
+        if(!expanded)
+            break;
     }
-    return NULL;
 }
 
 
 template <class Visitor>
-bool
-ParallelFindPrims(const UsdPrim& root,
-                  UsdTimeCode time,
-                  GusdPurposeSet purposes,
-                  UT_Array<UsdPrim>& prims,
-                  const Visitor& visitor,
-                  bool skipRoot)
+void
+ChunkedTraverseT<Visitor>::_TraverseSerial(const _Chunk& chunk,
+                                           const UsdPrim& prim,
+                                           bool visitPrim,
+                                           Visitor visitor,
+                                           TraverseSlot& slot,
+                                           UT_Interrupt* boss,
+                                           exint& counter) const
 {
-    TaskData data;
-    bool skipPrim = skipRoot || root.GetPath() == SdfPath::AbsoluteRootPath();
-    auto& task =
-        *new(UT_Task::allocate_root())
-        TraverseTaskT<Visitor>(root, -1, time, purposes,
-                               data, visitor, skipPrim);
-    UT_Task::spawnRootAndWait(task);
-    
-    if(UTgetInterrupt()->opInterrupt())
-        return false;
-    
-    return data.GatherPrimsFromThreads(prims);
+    if(visitPrim && !_Visit(chunk, visitor, prim, slot))
+        return;
+
+    for(const auto& child :
+            prim.GetFilteredChildren(_visitor.TraversalPredicate())) {
+        if(!(++counter & 0xff) && boss->opInterrupt())
+            return;
+        _TraverseSerial(chunk, child, /*visit prim*/ true, visitor,
+                        slot, boss, counter);
+    }
 }
 
 
 template <class Visitor>
-struct RunTasksT
+bool
+ChunkedTraverseT<Visitor>::Run()
 {
-    RunTasksT(const UT_Array<UsdPrim>& roots,
-              const GusdDefaultArray<UsdTimeCode>& times,
-              const GusdDefaultArray<GusdPurposeSet>& purposes,
-              const Visitor& visitor, TaskData& data, bool skipRoot)
-        : _roots(roots), _times(times), _purposes(purposes),
-          _visitor(visitor), _data(data), _skipRoot(skipRoot) {}
-    
-    void    operator()(const UT_BlockedRange<std::size_t>& r) const
-            {
-                auto* boss = GusdUTverify_ptr(UTgetInterrupt());
-
-                for(std::size_t i = r.begin(); i < r.end(); ++i)
-                {
-                    if(boss->opInterrupt())
-                        return;
-                    
-                    if(const UsdPrim& prim = _roots(i)) {
-                        bool skipPrim = _skipRoot ||
-                            prim.GetPath() == SdfPath::AbsoluteRootPath();
-
-                        auto& task =
-                            *new(UT_Task::allocate_root())
-                            TraverseTaskT<Visitor>(prim, i, _times(i),
-                                                   _purposes(i), _data,
-                                                   _visitor, skipPrim);
-                        UT_Task::spawnRootAndWait(task);
-                    }
+    _Split();
+
+    auto* boss = GusdUTverify_ptr(UTgetInterrupt());
+    const auto predicate = _visitor.TraversalPredicate();
+
+    UTparallelFor(UT_BlockedRange<exint>(0, _chunks.size()),
+        [&](const UT_BlockedRange<exint>& r)
+        {
+            exint counter = 0;
+            for(exint i = r.begin(); i < r.end(); ++i) {
+                if(boss->opInterrupt())
+                    return;
+                const _Chunk& chunk = _chunks(i);
+                if(!chunk.visitChildren)
+                    continue;
+
+                UsdPrim prim = chunk.prim;
+                for(exint n = 0; n < chunk.count; ++n) {
+                    if(n > 0)
+                        prim = prim.GetFilteredNextSibling(predicate);
+                    _TraverseSerial(chunk, prim, chunk.visitPrim,
+                                    chunk.visitor, _slots(i), boss, counter);
                 }
             }
+        }, /*subscribe ratio*/ 0, /*grain size*/ 1);
 
-private:
-    const UT_Array<UsdPrim>&                _roots;
-    const GusdDefaultArray<UsdTimeCode>&    _times;
-    const GusdDefaultArray<GusdPurposeSet>& _purposes;
-    const Visitor&                          _visitor;
-    TaskData&                               _data;
-    const bool                              _skipRoot;
-};
+    return !boss->opInterrupt();
+}
 
 
+template <class Visitor>
+bool
+ParallelFindPrims(const UsdPrim& root,
+                  UsdTimeCode time,
+                  GusdPurposeSet purposes,
+                  UT_Array<UsdPrim>& prims,
+                  const Visitor& visitor,
+                  bool skipRoot)
+{
+    ChunkedTraverseT<Visitor> traverse(visitor);
+    traverse.AddRoot(root, -1, time, purposes, skipRoot);
+    if(!traverse.Run())
+        return false;
+    return GatherPrimsFromSlots(traverse.GetSlots(), prims);
+}
 
 
 template <class Visitor>
@@ -295,14 +386,14 @@ ParallelFindPrims(const UT_Array<UsdPrim>& roots,
                   const Visitor& visitor,
                   bool skipRoot)
 {
-    TaskData data;
-    UTparallelFor(UT_BlockedRange<std::size_t>(0, roots.size()),
-                  RunTasksT<Visitor>(roots, times, purposes,
-                                     visitor, data, skipRoot));
-    if(UTgetInterrupt()->opInterrupt())
+    ChunkedTraverseT<Visitor> traverse(visitor);
+    for(exint i = 0; i < roots.size(); ++i) {
+        if(const UsdPrim& prim = roots(i))
+            traverse.AddRoot(prim, i, times(i), purposes(i), skipRoot);
+    }
+    if(!traverse.Run())
         return false;
-
-    return data.GatherPrimsFromThreads(prims);
+    return GatherPrimsFromSlots(traverse.GetSlots(), prims);
 }
 
 
@@ -27,6 +27,9 @@
 #include "gusd/USD_Utils.h"
 
 #include "pxr/base/arch/hints.h"
+#include "pxr/base/gf/interval.h"
+
+#include <algorithm>
 
 PXR_NAMESPACE_OPEN_SCOPE
 
@@ -232,6 +235,129 @@ GusdUSD_VisCache::GetResolvedVisibility(const UsdPrim& prim, UsdTimeCode time)
 }
 
 
+namespace {
+
+
+double
+_SampleTime(double start, double end, int numSamples, int i)
+{
+    return numSamples > 1 ? start + (end-start)*i/(numSamples-1) : start;
+}
+
+
+/** Query visibility at each sub-sample of [start,end].
+    Visibility is a token, so values are held between authored samples;
+    it's only queried at the start of the interval and at each authored
+    sample within it.*/
+void
+_QueryVisibilitySamples(const UsdAttributeQuery& query,
+                        double start, double end, int numSamples,
+                        UT_Array<bool>& vis)
+{
+    std::vector<double> times;
+    query.GetTimeSamplesInInterval(GfInterval(start, end), &times);
+
+    // Drop a sample exactly at the start; the start is always queried.
+    if(!times.empty() && times.front() <= start)
+        times.erase(times.begin());
+
+    const bool startVis = _QueryVisibility(query, UsdTimeCode(start));
+    UT_Array<bool> knots;
+    knots.setSize(times.size());
+    bool isConstant = true;
+    for(exint k = 0; k < knots.size(); ++k) {
+        knots(k) = _QueryVisibility(query, UsdTimeCode(times[k]));
+        isConstant &= (knots(k) == startVis);
+    }
+
+    if(isConstant) {
+        vis.setSize(1);
+        vis(0) = startVis;
+        return;
+    }
+
+    vis.setSize(numSamples);
+    for(int i = 0; i < numSamples; ++i) {
+        const double t = _SampleTime(start, end, numSamples, i);
+        const exint j = std::upper_bound(times.begin(), times.end(), t) -
+                        times.begin();
+        vis(i) = j == 0 ? startVis : knots(j-1);
+    }
+}
+
+
+/** Combine @a vis with the parent's resolved visibility samples,
+    collapsing back to a single value if the result is constant.*/
+void
+_CombineVisibilitySamples(UT_Array<bool>& vis,
+                          const UT_Array<bool>& parentVis)
+{
+    const exint n = SYSmax(vis.size(), parentVis.size());
+    UT_Array<bool> combined;
+    combined.setSize(n);
+    bool isConstant = true;
+    for(exint i = 0; i < n; ++i) {
+        combined(i) = vis(vis.size() == 1 ? 0 : i) &&
+                      parentVis(parentVis.size() == 1 ? 0 : i);
+        isConstant &= (combined(i) == combined(0));
+    }
+    if(isConstant) {
+        combined.setSize(1);
+    }
+    vis = std::move(combined);
+}
+
+
+} /*namespace*/
+
+
+bool
+GusdUSD_VisCache::GetResolvedVisibilitySamples(const UsdPrim& prim,
+                                               double start, double end,
+                                               int numSamples,
+                                               UT_Array<bool>& vis)
+{
+    vis.clear();
+
+    auto info = _GetVisInfo(prim);
+    if (ARCH_UNLIKELY(!info || numSamples < 1)) {
+        return false;
+    }
+
+    const int flags = info->flags.relaxedLoad();
+    if (numSamples == 1 || !(flags&FLAGS_RESOLVED_ISMAYBETIMEVARYING)) {
+        // Constant over the interval; this goes through the cached path.
+        vis.append(GetResolvedVisibility(prim, UsdTimeCode(start)));
+        return true;
+    }
+
+    if (flags&FLAGS_ISMAYBETIMEVARYING) {
+        _QueryVisibilitySamples(info->query, start, end, numSamples, vis);
+    } else {
+        vis.append(GetVisibility(prim, UsdTimeCode(start)));
+    }
+    if (vis.size() == 1 && !vis(0)) {
+        // Invisible over the whole interval, regardless of the parent.
+        return true;
+    }
+
+    if (UsdPrim parent = prim.GetParent()) {
+        if (!parent.IsPseudoRoot()) {
+            UT_Array<bool> parentVis;
+            if (!GetResolvedVisibilitySamples(parent, start, end,
+                                              numSamples, parentVis)) {
+                // Matches GetResolvedVisibility() for non-imageable parents.
+                vis.setSize(1);
+                vis(0) = false;
+                return true;
+            }
+            _CombineVisibilitySamples(vis, parentVis);
+        }
+    }
+    return true;
+}
+
+
 void
 GusdUSD_VisCache::Clear()
 {
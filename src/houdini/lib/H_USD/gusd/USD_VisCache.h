@@ -61,6 +61,18 @@ public:
     GUSD_API
     bool    GetResolvedVisibility(const UsdPrim& prim, UsdTimeCode time);
 
+    /** Compute resolved visibility at @a numSamples times, evenly spaced
+        over [start,end], as is needed for motion blur.
+        Authored visibility samples are read once for the whole interval.
+        If visibility is constant over the interval, @a vis holds a single
+        value. As with GetResolvedVisibility(), only unvarying visibility
+        is cached.*/
+    GUSD_API
+    bool    GetResolvedVisibilitySamples(const UsdPrim& prim,
+                                         double start, double end,
+                                         int numSamples,
+                                         UT_Array<bool>& vis);
+
     GUSD_API
     virtual void    Clear() override;
 
@@ -28,12 +28,18 @@
 #include "gusd/UT_CappedCache.h"
 
 #include "pxr/base/arch/hints.h"
+#include "pxr/usd/usd/stage.h"
 
 #include <UT/UT_Interrupt.h>
+#include <UT/UT_Map.h>
 #include <UT/UT_Matrix4.h>
 #include <UT/UT_ParallelUtil.h>
+#include <UT/UT_RWLock.h>
+#include <UT/UT_UniquePtr.h>
 #include <SYS/SYS_Version.h>
 
+#include <algorithm>
+
 PXR_NAMESPACE_OPEN_SCOPE
 
 namespace {
@@ -58,6 +64,100 @@ struct _CappedXformItem : public UT_CappedItem
 
 typedef UT_IntrusivePtr<const _CappedXformItem> _CappedXformItemHandle;
 
+
+/** Key for transform samples over an interval.*/
+struct _SampledKey
+{
+    _SampledKey(const UsdPrim& prim, double start, double end, int numSamples)
+        : prim(prim), start(start), end(end), numSamples(numSamples)
+        {
+            hash = SYShash(prim);
+            SYShashCombine(hash, start);
+            SYShashCombine(hash, end);
+            SYShashCombine(hash, numSamples);
+        }
+
+    bool    operator==(const _SampledKey& o) const
+            { return prim == o.prim && start == o.start && end == o.end &&
+                     numSamples == o.numSamples; }
+
+    struct HashCmp
+    {
+        static std::size_t  hash(const _SampledKey& key)
+                            { return key.hash; }
+        static bool         equal(const _SampledKey& a,
+                                  const _SampledKey& b)
+                            { return a == b; }
+    };
+
+    UsdPrim     prim;
+    double      start, end;
+    int         numSamples;
+    std::size_t hash;
+};
+
+typedef GusdUT_CappedKey<_SampledKey, _SampledKey::HashCmp> _SampledCappedKey;
+
+
+/** Flat table of world transforms for a single (stage, time) pair.
+    Filled in place by the batch world transform computation, so that
+    repeated batch queries resolve with a single path lookup per prim
+    rather than a walk up the hierarchy through the per-prim caches.*/
+struct _WorldXformTable : public UT_CappedItem
+{
+    typedef UT_Map<SdfPath, UT_Matrix4D, SdfPath::Hash> XformMap;
+
+    virtual ~_WorldXformTable() {}
+
+    /** XXX: The capped cache only samples this when the table is added,
+        so tables are charged for the size they have at that point.*/
+    virtual int64   getMemoryUsage() const override
+                    {
+                        UT_AutoReadLock readLock(lock);
+                        return sizeof(*this) +
+                               xforms.size()*(sizeof(XformMap::value_type) +
+                                              sizeof(void*)*2);
+                    }
+
+    bool            Find(const SdfPath& path, UT_Matrix4D& xform) const
+                    {
+                        UT_AutoReadLock readLock(lock);
+                        const auto it = xforms.find(path);
+                        if(it == xforms.end())
+                            return false;
+                        xform = it->second;
+                        return true;
+                    }
+
+    mutable UT_RWLock   lock;
+    XformMap            xforms;
+};
+
+typedef UT_IntrusivePtr<_WorldXformTable> _WorldXformTableHandle;
+
+
+_WorldXformTableHandle
+_FindOrAddWorldXformTable(GusdUT_CappedCache& cache,
+                          const UT_CappedKey& key,
+                          UT_Lock& lock)
+{
+    // Serialized, so that concurrent batches share the same table.
+    UT_AutoLock autoLock(lock);
+
+    if(auto item = cache.findItem(key))
+        return _WorldXformTableHandle(
+            UTverify_cast<_WorldXformTable*>(item.get()));
+
+    auto* table = new _WorldXformTable;
+    cache.addItem(key, UT_CappedItemHandle(table));
+    return _WorldXformTableHandle(table);
+}
+
+
+/** Batches smaller than this are computed prim-by-prim, since sorting
+    and gathering ancestors isn't worth it.*/
+constexpr exint _MinWorldXformBatchSize = 64;
+
 } /*namespace*/
 
 void
@@ -86,6 +186,24 @@ GusdUSD_XformCache::XformInfo::ComputeFlags(const UsdPrim& prim,
             _flags |= FLAGS_HAS_PARENT_XFORM;
         }
     }
+
+    if(_flags&FLAGS_LOCAL_MAYBE_TIMEVARYING) {
+        // Translations compose linearly, so if they are the only animated
+        // ops, the local transform can be interpolated between samples.
+        bool resetsXformStack = false;
+        bool linear = true;
+        for(const auto& op :
+                UsdGeomXformable(prim).GetOrderedXformOps(&resetsXformStack)) {
+            if(op.MightBeTimeVarying() &&
+               op.GetOpType() != UsdGeomXformOp::TypeTranslate) {
+                linear = false;
+                break;
+            }
+        }
+        if(linear) {
+            _flags |= FLAGS_LOCAL_LINEAR_MOTION;
+        }
+    }
 }
 
 
@@ -209,11 +327,188 @@ GusdUSD_XformCache::GetLocalToWorldTransform(const UsdPrim& prim,
 
 
 
+namespace {
+
+
+double
+_SampleTime(double start, double end, int numSamples, int i)
+{
+    return numSamples > 1 ? start + (end-start)*i/(numSamples-1) : start;
+}
+
+
+/** Evaluate the local transform at @a numSamples times over [start,end].
+    If the transform is constant over the interval, a single sample
+    is produced.*/
+bool
+_ComputeLocalSamples(const UsdGeomXformable::XformQuery& query,
+                     bool canInterpolate,
+                     double start, double end, int numSamples,
+                     UT_Array<UT_Matrix4D>& xforms)
+{
+    std::vector<double> times;
+    if(numSamples > 1) {
+        // Read the samples of all xformOps once.
+        query.GetTimeSamples(&times);
+    }
+
+    // Find the range of authored samples that bracket the interval.
+    auto lo = std::upper_bound(times.begin(), times.end(), start);
+    if(lo != times.begin())
+        --lo;
+    auto hi = std::lower_bound(times.begin(), times.end(), end);
+    if(hi != times.end())
+        ++hi;
+    const exint numKnots = hi > lo ? hi - lo : 0;
+
+    if(numKnots <= 1) {
+        // Values are held outside of the authored samples, so the
+        // transform is constant over the interval.
+        xforms.setSize(1);
+        return query.GetLocalTransformation(GusdUT_Gf::Cast(xforms.data()),
+                                            UsdTimeCode(start));
+    }
+
+    xforms.setSize(numSamples);
+
+    if(canInterpolate && numKnots < numSamples) {
+        UT_Array<UT_Matrix4D> knots;
+        knots.setSize(numKnots);
+        for(exint k = 0; k < numKnots; ++k) {
+            if(!query.GetLocalTransformation(GusdUT_Gf::Cast(&knots(k)),
+                                             UsdTimeCode(lo[k]))) {
+                return false;
+            }
+        }
+        for(int i = 0; i < numSamples; ++i) {
+            const double t = _SampleTime(start, end, numSamples, i);
+            const exint j = std::upper_bound(lo, hi, t) - lo;
+            if(j == 0) {
+                xforms(i) = knots(0);
+            } else if(j == numKnots) {
+                xforms(i) = knots(numKnots-1);
+            } else {
+                const double u = (t - lo[j-1])/(lo[j] - lo[j-1]);
+                UT_Matrix4D next = knots(j);
+                next *= u;
+                xforms(i) = knots(j-1);
+                xforms(i) *= 1.0 - u;
+                xforms(i) += next;
+            }
+        }
+        return true;
+    }
+
+    for(int i = 0; i < numSamples; ++i) {
+        if(!query.GetLocalTransformation(
+               GusdUT_Gf::Cast(&xforms(i)),
+               UsdTimeCode(_SampleTime(start, end, numSamples, i)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+} /*namespace*/
+
+
+GusdUSD_XformCache::XformSamplesHandle
+GusdUSD_XformCache::GetLocalTransformSamples(const UsdPrim& prim,
+                                             double start, double end,
+                                             int numSamples)
+{
+    const auto info = GetXformInfo(prim);
+    if(ARCH_UNLIKELY(!info || numSamples < 1)) {
+        return nullptr;
+    }
+    if(!info->LocalXformIsMaybeTimeVarying()) {
+        // Static prims share a single entry, regardless of the interval.
+        start = end = 0.0;
+        numSamples = 1;
+    }
+    _SampledCappedKey key(_SampledKey(prim, start, end, numSamples));
+
+    if(auto item = _localSamples.findItem(key)) {
+        return XformSamplesHandle(
+            UTverify_cast<const XformSamples*>(item.get()));
+    }
+
+    const bool canInterpolate =
+        info->LocalXformHasLinearMotion() &&
+        prim.GetStage()->GetInterpolationType() == UsdInterpolationTypeLinear;
+
+    UT_UniquePtr<XformSamples> samples(new XformSamples);
+    if(!_ComputeLocalSamples(info->query, canInterpolate,
+                             start, end, numSamples, samples->xforms)) {
+        return nullptr;
+    }
+    return XformSamplesHandle(
+        UTverify_cast<const XformSamples*>(
+            _localSamples.addItem(
+                key, UT_CappedItemHandle(samples.release())).get()));
+}
+
+
+GusdUSD_XformCache::XformSamplesHandle
+GusdUSD_XformCache::GetLocalToWorldTransformSamples(const UsdPrim& prim,
+                                                    double start, double end,
+                                                    int numSamples)
+{
+    const auto info = GetXformInfo(prim);
+    if(ARCH_UNLIKELY(!info || numSamples < 1)) {
+        return nullptr;
+    }
+    if(!info->WorldXformIsMaybeTimeVarying()) {
+        start = end = 0.0;
+        numSamples = 1;
+    }
+    _SampledCappedKey key(_SampledKey(prim, start, end, numSamples));
+
+    if(auto item = _worldSamples.findItem(key)) {
+        return XformSamplesHandle(
+            UTverify_cast<const XformSamples*>(item.get()));
+    }
+
+    const auto local = GetLocalTransformSamples(prim, start, end, numSamples);
+    if(!local) {
+        return nullptr;
+    }
+    XformSamplesHandle parent;
+    if(info->HasParentXform()) {
+        parent = GetLocalToWorldTransformSamples(prim.GetParent(),
+                                                 start, end, numSamples);
+        if(!parent) {
+            return nullptr;
+        }
+    }
+
+    UT_UniquePtr<XformSamples> samples(new XformSamples);
+    const bool isConstant =
+        local->IsConstant() && (!parent || parent->IsConstant());
+    samples->xforms.setSize(isConstant ? 1 : numSamples);
+    for(exint i = 0; i < samples->xforms.size(); ++i) {
+        samples->xforms(i) = (*local)(i);
+        if(parent) {
+            samples->xforms(i) *= (*parent)(i);
+        }
+    }
+    return XformSamplesHandle(
+        UTverify_cast<const XformSamples*>(
+            _worldSamples.addItem(
+                key, UT_CappedItemHandle(samples.release())).get()));
+}
+
+
 GusdUSD_XformCache::GusdUSD_XformCache(GusdStageCache& cache)
     : GusdUSD_DataCache(cache),
       _xforms(GUSDUT_USDCACHE_NAME, 512),
       _worldXforms(GUSDUT_USDCACHE_NAME, 512),
-      _xformInfos(GUSDUT_USDCACHE_NAME, 256) {}
+      _xformInfos(GUSDUT_USDCACHE_NAME, 256),
+      _worldXformTables(GUSDUT_USDCACHE_NAME, 256),
+      _staticWorldXformTables(GUSDUT_USDCACHE_NAME, 256),
+      _localSamples(GUSDUT_USDCACHE_NAME, 256),
+      _worldSamples(GUSDUT_USDCACHE_NAME, 256) {}
 
     
 GusdUSD_XformCache::GusdUSD_XformCache()
@@ -326,8 +621,218 @@ GusdUSD_XformCache::GetLocalToWorldTransforms(
     const GusdDefaultArray<UsdTimeCode>& times,
     UT_Matrix4D* xforms)
 {
-    return _ComputeXforms<_WorldXformFn>(_WorldXformFn(*this),
-                                         prims, times, xforms);
+    if(prims.size() < _MinWorldXformBatchSize) {
+        return _ComputeXforms<_WorldXformFn>(_WorldXformFn(*this),
+                                             prims, times, xforms);
+    }
+
+    // Sort the valid prims by (stage, time, path), so that each (stage, time)
+    // pair forms a contiguous run that can be computed as a single batch.
+    UT_Array<exint> order;
+    order.setCapacity(prims.size());
+    for(exint i = 0; i < prims.size(); ++i) {
+        if(prims(i)) {
+            order.append(i);
+        } else {
+            xforms[i].identity();
+        }
+    }
+    std::sort(order.begin(), order.end(),
+              [&](exint a, exint b)
+              {
+                  const UsdStage* stageA = get_pointer(prims(a).GetStage());
+                  const UsdStage* stageB = get_pointer(prims(b).GetStage());
+                  if(stageA != stageB)
+                      return stageA < stageB;
+                  if(times(a) != times(b))
+                      return times(a) < times(b);
+                  return prims(a).GetPath() < prims(b).GetPath();
+              });
+
+    for(exint start = 0; start < order.size(); ) {
+        const UsdStage* stage = get_pointer(prims(order(start)).GetStage());
+        const UsdTimeCode time = times(order(start));
+
+        exint end = start + 1;
+        while(end < order.size() &&
+              get_pointer(prims(order(end)).GetStage()) == stage &&
+              times(order(end)) == time) {
+            ++end;
+        }
+        if(!_ComputeWorldXformBatch(prims, order, start, end, time, xforms))
+            return false;
+        start = end;
+    }
+    return true;
+}
+
+
+bool
+GusdUSD_XformCache::_ComputeWorldXformBatch(
+    const UT_Array<UsdPrim>& prims,
+    const UT_Array<exint>& order,
+    exint start, exint end,
+    UsdTimeCode time,
+    UT_Matrix4D* xforms)
+{
+    struct _Node
+    {
+        UsdPrim         prim;
+        XformInfoHandle info;
+        UT_Matrix4D     xform;
+        bool            valid = false;
+        bool            cached = false;
+    };
+
+    // World transforms that aren't time varying are shared by all times,
+    // as with the time remapping in GetLocalToWorldTransform(), so they
+    // are kept in a separate table for the stage.
+    const UsdPrim pseudoRoot = prims(order(start)).GetStage()->GetPseudoRoot();
+    const _WorldXformTableHandle varyingTable = _FindOrAddWorldXformTable(
+        _worldXformTables,
+        _VaryingKey(GusdUSD_VaryingPropertyKey(pseudoRoot, time)),
+        _worldXformTablesLock);
+    const _WorldXformTableHandle staticTable = _FindOrAddWorldXformTable(
+        _staticWorldXformTables,
+        _UnvaryingKey(GusdUSD_UnvaryingPropertyKey(pseudoRoot)),
+        _worldXformTablesLock);
+
+    auto findXform = [&](const SdfPath& path, UT_Matrix4D& xform)
+    {
+        return staticTable->Find(path, xform) ||
+               varyingTable->Find(path, xform);
+    };
+
+    // Look up the requested prims in the tables first. For repeated
+    // queries, this is all there is to do.
+    const exint count = end - start;
+    UT_Array<char> missed;
+    missed.setSizeNoInit(count);
+    UTparallelForLightItems(UT_BlockedRange<exint>(0, count),
+        [&](const UT_BlockedRange<exint>& r)
+        {
+            for(exint i = r.begin(); i < r.end(); ++i) {
+                const exint idx = order(start+i);
+                missed(i) = !findXform(prims(idx).GetPath(), xforms[idx]);
+            }
+        });
+
+    // Gather every missing prim, along with its ancestors. Each unique prim
+    // is added exactly once. The prims are sorted by path, so the walk up
+    // the hierarchy usually ends at an ancestor gathered for a sibling.
+    UT_Array<_Node> nodes;
+    UT_Map<SdfPath, exint, SdfPath::Hash> nodeIndex;
+
+    for(exint i = 0; i < count; ++i) {
+        if(!missed(i))
+            continue;
+        for(UsdPrim p = prims(order(start+i)); p && !p.IsPseudoRoot();
+            p = p.GetParent()) {
+
+            if(!nodeIndex.emplace(p.GetPath(), nodes.size()).second)
+                break;
+            nodes(nodes.append()).prim = p;
+        }
+    }
+    if(nodes.isEmpty())
+        return true;
+
+    // Building the xform queries and probing the tables is the bulk of
+    // the work for a cold batch, so do that in parallel.
+    UTparallelFor(UT_BlockedRange<exint>(0, nodes.size()),
+        [&](const UT_BlockedRange<exint>& r)
+        {
+            for(exint i = r.begin(); i < r.end(); ++i) {
+                _Node& node = nodes(i);
+                node.info = GetXformInfo(node.prim);
+                if(node.info && findXform(node.prim.GetPath(), node.xform)) {
+                    node.valid = true;
+                    node.cached = true;
+                }
+            }
+        });
+
+    // Bucket the prims that still need computing by depth.
+    UT_Array<UT_Array<exint>> levels;
+    for(exint n = 0; n < nodes.size(); ++n) {
+        const _Node& node = nodes(n);
+        if(node.cached || !node.info)
+            continue;
+
+        const exint depth = node.prim.GetPath().GetPathElementCount();
+        if(levels.size() <= depth)
+            levels.setSize(depth+1);
+        levels(depth).append(n);
+    }
+
+    // Compute each level in parallel. Parents are always at a lower depth,
+    // or were found in the tables, so they are complete by the time their
+    // children are visited.
+    auto* boss = UTgetInterrupt();
+    for(exint depth = 0; depth < levels.size(); ++depth) {
+        const UT_Array<exint>& level = levels(depth);
+        if(level.isEmpty())
+            continue;
+
+        UTparallelFor(UT_BlockedRange<exint>(0, level.size()),
+            [&](const UT_BlockedRange<exint>& r)
+            {
+                char bcnt = 0;
+                for(exint i = r.begin(); i < r.end(); ++i) {
+                    if(!++bcnt && boss->opInterrupt())
+                        return;
+
+                    _Node& node = nodes(level(i));
+                    if(!_GetLocalTransformation(node.prim, time,
+                                                node.xform, node.info)) {
+                        continue;
+                    }
+                    if(node.info->HasParentXform()) {
+                        const auto it = nodeIndex.find(
+                            node.prim.GetPath().GetParentPath());
+                        UT_ASSERT_P(it != nodeIndex.end());
+                        const _Node& parent = nodes(it->second);
+                        if(!parent.valid)
+                            continue;
+                        node.xform *= parent.xform;
+                    }
+                    node.valid = true;
+                }
+            });
+        if(boss->opInterrupt())
+            return false;
+    }
+
+    // Add the new transforms to the tables in place, rather than replacing
+    // them, so that concurrent batches keep each other's entries.
+    auto publish = [&](_WorldXformTable& table, bool varying)
+    {
+        UT_AutoWriteLock writeLock(table.lock);
+        for(const UT_Array<exint>& level : levels) {
+            for(exint n : level) {
+                const _Node& node = nodes(n);
+                if(node.valid &&
+                   node.info->WorldXformIsMaybeTimeVarying() == varying) {
+                    table.xforms[node.prim.GetPath()] = node.xform;
+                }
+            }
+        }
+    };
+    publish(*staticTable, /*varying*/ false);
+    publish(*varyingTable, /*varying*/ true);
+
+    for(exint i = 0; i < count; ++i) {
+        if(!missed(i))
+            continue;
+        const exint idx = order(start+i);
+        const _Node& node = nodes(nodeIndex[prims(idx).GetPath()]);
+        if(node.valid) {
+            xforms[idx] = node.xform;
+        } else {
+            xforms[idx].identity();
+        }
+    }
+    return true;
 }
 
 
@@ -438,6 +943,10 @@ GusdUSD_XformCache::Clear()
     _xforms.clear();
     _worldXforms.clear();
     _xformInfos.clear();
+    _worldXformTables.clear();
+    _staticWorldXformTables.clear();
+    _localSamples.clear();
+    _worldSamples.clear();
 }
 
 
@@ -467,7 +976,11 @@ GusdUSD_XformCache::Clear(const UT_StringSet& paths)
 {   
     return _RemoveKeysT<_VaryingKey>(paths, _xforms) +
            _RemoveKeysT<_VaryingKey>(paths, _worldXforms ) +
-           _RemoveKeysT<_UnvaryingKey>(paths, _xformInfos);
+           _RemoveKeysT<_UnvaryingKey>(paths, _xformInfos) +
+           _RemoveKeysT<_VaryingKey>(paths, _worldXformTables) +
+           _RemoveKeysT<_UnvaryingKey>(paths, _staticWorldXformTables) +
+           _RemoveKeysT<_SampledCappedKey>(paths, _localSamples) +
+           _RemoveKeysT<_SampledCappedKey>(paths, _worldSamples);
 }
 
 PXR_NAMESPACE_CLOSE_SCOPE
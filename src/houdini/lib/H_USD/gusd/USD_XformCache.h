@@ -31,6 +31,8 @@
 #include "gusd/USD_DataCache.h"
 #include "gusd/USD_Utils.h"
 
+#include <UT/UT_Lock.h>
+
 #include "pxr/pxr.h"
 #include "pxr/usd/usdGeom/xformable.h"
 
@@ -63,7 +65,12 @@ public:
                 const GusdDefaultArray<UsdTimeCode>& times,
                 UT_Matrix4D* xfroms);
 
-    /** Compute multiple world transforms in parallel.*/
+    /** Compute multiple world transforms in parallel.
+        Large batches are grouped by stage and time and sorted by path, so
+        that each unique ancestor is computed once, level by level. Results
+        are kept in flat per-(stage, time) tables, which later batches
+        consult before computing anything. World transforms that are not
+        time-varying share a single table per stage.*/
     bool    GetLocalToWorldTransforms(
                 const UT_Array<UsdPrim>& prims,
                 const GusdDefaultArray<UsdTimeCode>& times,
@@ -86,13 +93,55 @@ public:
                 const GusdDefaultArray<UsdTimeCode>& times,
                 UT_Matrix4D* xforms);
 
+    /** Transforms evaluated at evenly spaced times over an interval.
+        Holds a single transform when the transform is constant over
+        the whole interval.*/
+    struct XformSamples : public UT_CappedItem
+    {
+        virtual ~XformSamples() {}
+
+        virtual int64       getMemoryUsage() const override
+                            { return sizeof(*this) +
+                                     xforms.getMemoryUsage(false); }
+
+        bool                IsConstant() const
+                            { return xforms.size() == 1; }
+
+        const UT_Matrix4D&  operator()(exint i) const
+                            { return xforms(IsConstant() ? 0 : i); }
+
+        UT_Array<UT_Matrix4D>   xforms;
+    };
+    typedef UT_IntrusivePtr<const XformSamples> XformSamplesHandle;
+
+    /** Compute local transforms at @a numSamples times, evenly spaced over
+        [start,end], as is needed for motion blur.
+        The time samples of the prim's xformOps are read once for the
+        whole interval, and sub-samples are interpolated from the authored
+        samples when that is exact. Prims whose transform is constant over
+        the interval get a single sample. Results are cached.*/
+    GUSD_API
+    XformSamplesHandle  GetLocalTransformSamples(const UsdPrim& prim,
+                                                 double start, double end,
+                                                 int numSamples);
+
+    /** World-space variant of GetLocalTransformSamples().*/
+    GUSD_API
+    XformSamplesHandle  GetLocalToWorldTransformSamples(const UsdPrim& prim,
+                                                        double start,
+                                                        double end,
+                                                        int numSamples);
+
     struct XformInfo : public UT_CappedItem
     {
         enum Flags
         {
             FLAGS_LOCAL_MAYBE_TIMEVARYING=0x1,
             FLAGS_WORLD_MAYBE_TIMEVARYING=0x2,
-            FLAGS_HAS_PARENT_XFORM=0x4
+            FLAGS_HAS_PARENT_XFORM=0x4,
+            /// All time-varying ops are translations, so the local
+            /// transform is linear between authored samples.
+            FLAGS_LOCAL_LINEAR_MOTION=0x8
         };
 
         XformInfo(const UsdGeomXformable& xf)
@@ -114,6 +163,9 @@ public:
         SYS_FORCE_INLINE bool   HasParentXform() const
                                 { return _flags&FLAGS_HAS_PARENT_XFORM; }
 
+        SYS_FORCE_INLINE bool   LocalXformHasLinearMotion() const
+                                { return _flags&FLAGS_LOCAL_LINEAR_MOTION; }
+
         const UsdGeomXformable::XformQuery  query;
     private:
         int                                 _flags;
@@ -135,11 +187,21 @@ private:
                                     UsdTimeCode time,
                                     UT_Matrix4D& xform,
                                     const XformInfoHandle& info);
-                                    
+
+    /** Compute world transforms for order[start,end), which must all
+        reference prims on the same stage, at @a time.*/
+    bool    _ComputeWorldXformBatch(const UT_Array<UsdPrim>& prims,
+                                    const UT_Array<exint>& order,
+                                    exint start, exint end,
+                                    UsdTimeCode time,
+                                    UT_Matrix4D* xforms);
 
 
 private:
     GusdUT_CappedCache  _xforms, _worldXforms, _xformInfos;
+    GusdUT_CappedCache  _worldXformTables, _staticWorldXformTables;
+    UT_Lock             _worldXformTablesLock;
+    GusdUT_CappedCache  _localSamples, _worldSamples;
 };
 
 PXR_NAMESPACE_CLOSE_SCOPE
@@ -23,6 +23,12 @@
 //
 #include "boundsCache.h"
 
+#include <SYS/SYS_Math.h>
+#include <SYS/SYS_SequentialThreadIndex.h>
+#include <UT/UT_Interrupt.h>
+#include <UT/UT_ParallelUtil.h>
+#include <UT/UT_Thread.h>
+
 #include <iostream>
 
 PXR_NAMESPACE_OPEN_SCOPE
@@ -32,6 +38,66 @@ using std::endl;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// UsdGeomBBoxCache does not report its footprint, so we charge each shard
+// a nominal amount when deciding what to evict.
+const int64 theNominalShardMemory = 256 * 1024;
+
+// Upper bound on the number of bbox caches kept per key. More shards
+// reduce contention but each one recomputes shared ancestor extents.
+const int theMaxShards = 16;
+
+} // namespace
+
+GusdBoundsCache::Item::Item(
+    UsdTimeCode time,
+    const TfTokenVector& includedPurposes,
+    int numShards )
+    : UT_CappedItem()
+{
+    shards.setCapacity( numShards );
+    for( int i = 0; i < numShards; ++i )
+        shards.emplace_back( UTmakeUnique<Shard>( time, includedPurposes ));
+}
+
+GusdBoundsCache::Item::~Item()
+{
+}
+
+int64
+GusdBoundsCache::Item::getMemoryUsage() const
+{
+    return sizeof(*this) + shards.size() * theNominalShardMemory;
+}
+
+GusdBoundsCache::Shard &
+GusdBoundsCache::Item::Acquire( std::unique_lock<std::mutex> &lock ) const
+{
+    const int n = shards.size();
+    const int home = SYSgetSTID() % n;
+
+    // Prefer whichever shard is free, starting with our own so that a
+    // thread tends to keep hitting the cache it already populated.
+    for( int i = 0; i < n; ++i )
+    {
+        Shard &shard = *shards[(home + i) % n];
+        std::unique_lock<std::mutex> tryLock( shard.lock, std::try_to_lock );
+        if( tryLock.owns_lock() )
+        {
+            lock = std::move( tryLock );
+            return shard;
+        }
+    }
+
+    // Everything is busy; wait on our own shard.
+    Shard &shard = *shards[home];
+    lock = std::unique_lock<std::mutex>( shard.lock );
+    return shard;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 /* static */ 
 GusdBoundsCache &
 GusdBoundsCache::GetInstance()
@@ -41,6 +107,8 @@ GusdBoundsCache::GetInstance()
 }
 
 GusdBoundsCache::GusdBoundsCache() 
+    : m_cache( GUSDUT_USDCACHE_NAME, 256 )
+    , m_numShards( SYSclamp( UT_Thread::getNumProcessors(), 1, theMaxShards ))
 {
 }
 
@@ -48,6 +116,12 @@ GusdBoundsCache::~GusdBoundsCache()
 {
 }
 
+void
+GusdBoundsCache::SetMaxSizeMB(int64 size_in_mb)
+{
+    m_cache.setMaxSize( size_in_mb );
+}
+
 bool 
 GusdBoundsCache::ComputeWorldBound(
     const UsdPrim &prim,
@@ -78,6 +152,78 @@ GusdBoundsCache::ComputeUntransformedBound(
                 bounds );
 }
 
+bool
+GusdBoundsCache::ComputeWorldBounds(
+    const UT_Array<UsdPrim> &prims,
+    UsdTimeCode time,
+    const TfTokenVector &includedPurposes,
+    UT_BoundingBox *bounds )
+{
+    return _ComputeBounds(
+                prims,
+                time,
+                includedPurposes,
+                &UsdGeomBBoxCache::ComputeWorldBound,
+                bounds );
+}
+
+bool
+GusdBoundsCache::ComputeUntransformedBounds(
+    const UT_Array<UsdPrim> &prims,
+    UsdTimeCode time,
+    const TfTokenVector &includedPurposes,
+    UT_BoundingBox *bounds )
+{
+    return _ComputeBounds(
+                prims,
+                time,
+                includedPurposes,
+                &UsdGeomBBoxCache::ComputeUntransformedBound,
+                bounds );
+}
+
+GusdBoundsCache::ItemHandle
+GusdBoundsCache::_FindOrCreateItem(
+    const UsdStagePtr &stage,
+    UsdTimeCode time,
+    const TfTokenVector &includedPurposes )
+{
+    TfToken stageId( stage->GetRootLayer()->IsAnonymous()
+	    ? stage->GetRootLayer()->GetIdentifier()
+	    : stage->GetRootLayer()->GetRealPath() );
+
+    const CappedKey key( Key( stageId, includedPurposes, time ));
+    const int numShards = m_numShards;
+    return m_cache.FindOrCreate<Item>( key,
+        [&]() {
+            return UT_CappedItemHandle(
+                new Item( time, includedPurposes, numShards ));
+        });
+}
+
+namespace {
+
+bool
+_ToBoundingBox( const GfBBox3d &primBBox, UT_BoundingBox &bounds )
+{
+    if( primBBox.GetRange().IsEmpty() ) 
+        return false;
+
+    const GfRange3d rng = primBBox.ComputeAlignedRange();
+
+    bounds = 
+        UT_BoundingBox( 
+            rng.GetMin()[0],
+            rng.GetMin()[1],
+            rng.GetMin()[2],
+            rng.GetMax()[0],
+            rng.GetMax()[1],
+            rng.GetMax()[2]);
+    return true;
+}
+
+} // namespace
+
 bool 
 GusdBoundsCache::_ComputeBound(
     const UsdPrim &prim,
@@ -89,63 +235,87 @@ GusdBoundsCache::_ComputeBound(
     if( !prim.IsValid() )
         return false;
 
-    TfToken stageId( prim.GetStage()->GetRootLayer()->IsAnonymous()
-	    ? prim.GetStage()->GetRootLayer()->GetIdentifier()
-	    : prim.GetStage()->GetRootLayer()->GetRealPath() );
-
-    MapType::accessor accessor;
-    if( !m_map.find( accessor, Key( stageId, includedPurposes ))) {
-        m_map.insert( accessor, Key( stageId, includedPurposes ) );
-        accessor->second = new Item( time, includedPurposes );
-    }
-    std::lock_guard<std::mutex> lock(accessor->second->lock);
-    UsdGeomBBoxCache& cache = accessor->second->bboxCache;
+    ItemHandle item = _FindOrCreateItem( prim.GetStage(), time,
+                                         includedPurposes );
+    if( !item )
+        return false;
 
-    cache.SetTime( time );
+    std::unique_lock<std::mutex> lock;
+    UsdGeomBBoxCache& cache = item->Acquire( lock ).bboxCache;
 
     // boundFunc is either ComputeWorldBound or ComputeLocalBound
     GfBBox3d primBBox = (cache.*boundFunc)(prim);
+    lock.unlock();
 
-    if( !primBBox.GetRange().IsEmpty() ) 
-    {
-        const GfRange3d rng = primBBox.ComputeAlignedRange();
-
-        bounds = 
-            UT_BoundingBox( 
-                rng.GetMin()[0],
-                rng.GetMin()[1],
-                rng.GetMin()[2],
-                rng.GetMax()[0],
-                rng.GetMax()[1],
-                rng.GetMax()[2]);
+    return _ToBoundingBox( primBBox, bounds );
+}
+
+bool
+GusdBoundsCache::_ComputeBounds(
+    const UT_Array<UsdPrim> &prims,
+    UsdTimeCode time,
+    const TfTokenVector &includedPurposes,
+    ComputeFunc boundFunc,
+    UT_BoundingBox *bounds )
+{
+    // Find the cache entry once for the whole batch.
+    ItemHandle item;
+    for( const UsdPrim &prim : prims ) {
+        if( prim.IsValid() ) {
+            item = _FindOrCreateItem( prim.GetStage(), time,
+                                      includedPurposes );
+            break;
+        }
+    }
+
+    if( !item ) {
+        for( exint i = 0; i < prims.size(); ++i )
+            bounds[i].makeInvalid();
         return true;
     }
 
-    return false;
+    UTparallelFor(UT_BlockedRange<exint>(0, prims.size()),
+        [&](const UT_BlockedRange<exint>& r)
+        {
+            auto* boss = UTgetInterrupt();
+            char bcnt = 0;
+
+            // Hold a single shard for the whole block so that neighbouring
+            // prims share their ancestors' cached extents.
+            std::unique_lock<std::mutex> lock;
+            UsdGeomBBoxCache& cache = item->Acquire( lock ).bboxCache;
+
+            for( exint i = r.begin(); i < r.end(); ++i ) {
+                if( !++bcnt && boss->opInterrupt() )
+                    return;
+
+                const UsdPrim &prim = prims(i);
+                if( !prim.IsValid() ||
+                    !_ToBoundingBox( (cache.*boundFunc)(prim), bounds[i] )) {
+                    bounds[i].makeInvalid();
+                }
+            }
+        }, /*subscribe_ratio*/ 2, /*min_grain_size*/ 64);
+
+    return !UTgetInterrupt()->opInterrupt();
 }
 
 void
 GusdBoundsCache::Clear()
 {
-    m_map.clear();
+    m_cache.clear();
 }
 
 int64 
 GusdBoundsCache::Clear(const UT_StringSet& paths)
 {
-    int64 freed = 0;
+    return m_cache.ClearEntries(
+        [&](const UT_CappedKeyHandle& key,
+            const UT_CappedItemHandle& item) {
 
-    UT_Array<Key> keys;
-    for( auto const& entry : m_map ) {
-        if( paths.contains( entry.first.path.GetString() ) ) {
-            keys.append( entry.first );
-        }
-    }
-
-    for( auto const& k : keys ) {
-        m_map.erase( k );
-    }
-    return freed;    
+        return paths.contains(
+            (*UTverify_cast<const CappedKey*>(key.get()))->path.GetString() );
+    });
 }
 
 PXR_NAMESPACE_CLOSE_SCOPE
@@ -26,25 +26,33 @@
 
 #include "pxr/pxr.h"
 #include "pxr/usd/usd/prim.h"
+#include "pxr/usd/usd/stage.h"
 #include "pxr/usd/usdGeom/bboxCache.h"
 #include "pxr/base/tf/token.h"
 
 #include "USD_DataCache.h"
+#include "UT_CappedCache.h"
 
+#include <SYS/SYS_Hash.h>
+#include <UT/UT_Array.h>
 #include <UT/UT_BoundingBox.h>
 #include <UT/UT_IntrusivePtr.h>
-#include <UT/UT_ConcurrentHashMap.h>
+#include <UT/UT_UniquePtr.h>
+
+#include <mutex>
 
 PXR_NAMESPACE_OPEN_SCOPE
 
 /// A wrapper arround UsdGeomBBoxCache. 
 ///
-/// This singleton class keeps a cache per stage and per purpose.
+/// This singleton class keeps caches per stage, per purpose and per time.
 /// It will be flushed when the stage cache is flushed. 
 ///
-/// Unfortunaly UsdGeomBBoxCaches only store a single frame at
-/// a time. I considered creating a cache per frame but I thought
-/// that would defeat optimizations for non animated geometry.
+/// UsdGeomBBoxCaches only store a single frame at a time and are not
+/// thread-safe, so each (stage, purposes, time) entry holds a small set of
+/// independently locked bbox caches that concurrent queries are spread
+/// across. Entries live in a memory-capped cache, so the least recently
+/// used times and stages are evicted once the budget is exceeded.
 
 class GusdBoundsCache : public GusdUSD_DataCache {
 public:
@@ -65,28 +73,54 @@ public:
             const TfTokenVector &includedPurposes,
             UT_BoundingBox &bounds );
 
+    /// Compute world bounds for a batch of prims that all belong to the
+    /// same stage, in parallel. Prims without bounds get an invalid box.
+    /// Returns false if the operation was interrupted.
+    bool ComputeWorldBounds(
+            const UT_Array<UsdPrim> &prims,
+            UsdTimeCode time,
+            const TfTokenVector &includedPurposes,
+            UT_BoundingBox *bounds );
+
+    /// Batch version of ComputeUntransformedBound. See ComputeWorldBounds.
+    bool ComputeUntransformedBounds(
+            const UT_Array<UsdPrim> &prims,
+            UsdTimeCode time,
+            const TfTokenVector &includedPurposes,
+            UT_BoundingBox *bounds );
+
     virtual void Clear() override;
     virtual int64 Clear(const UT_StringSet& stageNames) override;
 
+    /// Set the memory budget (in MB) of the cache. Least recently used
+    /// (stage, purposes, time) entries are evicted beyond this size.
+    void SetMaxSizeMB(int64 size_in_mb);
+
 private:
 
-    // Key that hashes the stage file name and a set of purposes.
+    // Key that hashes the stage file name, a set of purposes and a time.
     struct Key 
     {
         Key() : hash(0) {}
         
-        Key(const TfToken &path, TfTokenVector purposes)
-            : path(path), purposes( purposes ), hash(ComputeHash(path,purposes)) {}
-
-        static std::size_t  ComputeHash(const TfToken &path, TfTokenVector purposes)
+        Key(const TfToken &path, const TfTokenVector &purposes,
+            UsdTimeCode time)
+            : path(path), purposes( purposes ), time( time ),
+              hash(ComputeHash(path,purposes,time)) {}
+
+        static std::size_t  ComputeHash(const TfToken &path,
+                                        const TfTokenVector &purposes,
+                                        UsdTimeCode time)
                             {
                                 std::size_t h = hash_value(path);
                                 BOOST_NS::hash_combine(h, purposes);
+                                SYShashCombine(h, time);
                                 return h; 
                             }
 
         bool                operator==(const Key& o) const
                             { return path == o.path &&
+                                     time == o.time &&
                                      purposes == o.purposes ; }
 
         friend size_t       hash_value(const Key& o)
@@ -103,12 +137,14 @@ private:
 
         TfToken             path;
         TfTokenVector       purposes;
+        UsdTimeCode         time;
         std::size_t         hash;
     };
 
-    struct Item : public UT_IntrusiveRefCounter<Item>
+    // One independently locked UsdGeomBBoxCache.
+    struct Shard
     {
-        Item( UsdTimeCode time, const TfTokenVector& includedPurposes ) 
+        Shard( UsdTimeCode time, const TfTokenVector& includedPurposes ) 
             : bboxCache( time, includedPurposes )
         {
         }
@@ -117,6 +153,22 @@ private:
         std::mutex lock;
     };
 
+    // All bbox caches for a single (stage, purposes, time) key.
+    struct Item : public UT_CappedItem
+    {
+        Item( UsdTimeCode time, const TfTokenVector& includedPurposes,
+              int numShards );
+        virtual ~Item();
+
+        virtual int64 getMemoryUsage() const override;
+
+        /// Lock and return one of the shards, preferring the calling
+        /// thread's own shard and any shard that is not currently in use.
+        Shard& Acquire( std::unique_lock<std::mutex> &lock ) const;
+
+        UT_Array<UT_UniquePtr<Shard>> shards;
+    };
+
     typedef GfBBox3d (UsdGeomBBoxCache::*ComputeFunc)(const UsdPrim& prim);
 
     bool _ComputeBound(
@@ -126,10 +178,23 @@ private:
             ComputeFunc boundFunc,
             UT_BoundingBox &bounds );   
 
-    typedef UT_IntrusivePtr<Item> ItemHandle;
+    bool _ComputeBounds(
+            const UT_Array<UsdPrim> &prims,
+            UsdTimeCode time,
+            const TfTokenVector &includedPurposes,
+            ComputeFunc boundFunc,
+            UT_BoundingBox *bounds );
+
+    typedef GusdUT_CappedKey<Key,Key::HashCmp> CappedKey;
+    typedef UT_IntrusivePtr<const Item> ItemHandle;
+
+    ItemHandle _FindOrCreateItem(
+            const UsdStagePtr &stage,
+            UsdTimeCode time,
+            const TfTokenVector &includedPurposes );
 
-    typedef UT_ConcurrentHashMap<Key,ItemHandle,Key::HashCmp> MapType;
-    MapType   m_map;
+    GusdUT_CappedCache  m_cache;
+    int                 m_numShards;
 };
 
 PXR_NAMESPACE_CLOSE_SCOPE
@@ -24,6 +24,7 @@
 #include "meshWrapper.h"
 
 #include "context.h"
+#include "GT_ReverseWindingArray.h"
 #include "GT_VtArray.h"
 #include "GU_USD.h"
 #include "tokens.h"
@@ -525,16 +526,13 @@ GusdMeshWrapper::refine(
         return false;
     }
 
-    GT_DataArrayHandle gtIndicesHandle;
+    GT_DataArrayHandle gtIndicesHandle = new GusdGT_VtArray<int32>( usdFaceIndex );
+    GT_DataArrayHandle gtReverseWinding;
     if( reverseWindingOrder ) {
-        // Make a copy and reorder
-        gtIndicesHandle = new GT_Int32Array(usdFaceIndex.cdata(),
-                            usdFaceIndex.size(), 1);
-        _reverseWindingOrder(UTverify_cast<GT_Int32Array*>(gtIndicesHandle.get()),
-                             gtVertexCounts);
-    }
-    else {
-        gtIndicesHandle = new GusdGT_VtArray<int32>( usdFaceIndex );
+        // Read the indices through a lazy reordering rather than copying
+        // them. The same reordering is applied to vertex attributes below.
+        gtReverseWinding = new GusdGT_ReverseWindingArray( gtVertexCounts );
+        gtIndicesHandle = new GT_DAIndirect( gtReverseWinding, gtIndicesHandle );
     }
 
     // point positions
@@ -707,17 +705,8 @@ GusdMeshWrapper::refine(
 
     if( gtVertexAttrs->entries() > 0 ) {
         if( reverseWindingOrder ) {
-            // Construct an index array which will be used to lookup vertex
-            // attributes in the correct order.
-            GT_Int32Array* vertexIndirect
-                = new GT_Int32Array(gtIndicesHandle->entries(), 1);
-            GT_DataArrayHandle vertexIndirectHandle(vertexIndirect);
-            for(int i=0; i<gtIndicesHandle->entries(); ++i) {
-                vertexIndirect->set(i, i);
-            }
-            _reverseWindingOrder(vertexIndirect, gtVertexCounts );
-
-            gtVertexAttrs = gtVertexAttrs->createIndirect(vertexIndirect);
+            // Look up vertex attributes in the reversed order.
+            gtVertexAttrs = gtVertexAttrs->createIndirect(gtReverseWinding);
         }
     }
 
@@ -25,6 +25,7 @@
 
 #include "context.h"
 #include "GT_VtArray.h"
+#include "GT_VtStringArray.h"
 #include "GU_USD.h"
 #include "tokens.h"
 #include "USD_XformCache.h"
@@ -822,6 +823,11 @@ Gusd_ConvertStringArrayToGt(const UsdAttribute& attr, const VtValue& val)
     if (array.size() > 0) {
         const int elementSize = Gusd_GetElementSize(attr);
         if (elementSize > 0) {
+            if (elementSize == 1) {
+                // Reference the strings in place rather than copying them.
+                return new GusdGT_VtStringArray<ELEMTYPE>(array);
+            }
+
             const size_t numTuples = array.size()/elementSize;
             if (numTuples*elementSize == array.size()) {
                 const ELEMTYPE* values = array.cdata();
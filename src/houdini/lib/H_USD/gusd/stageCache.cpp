@@ -29,12 +29,15 @@
 #include <UT/UT_Exit.h>
 #include <UT/UT_Interrupt.h>
 #include <UT/UT_Lock.h>
+#include <UT/UT_Map.h>
+#include <UT/UT_NonCopyable.h>
 #include <UT/UT_ParallelUtil.h>
 #include <UT/UT_RWLock.h>
 #include <UT/UT_StringHolder.h>
 #include <UT/UT_StringSet.h>
 #include <UT/UT_Thread.h>
 #include <UT/UT_WorkBuffer.h>
+#include <SYS/SYS_SequentialThreadIndex.h>
 
 #include "gusd/debugCodes.h"
 #include "gusd/error.h"
@@ -53,7 +56,11 @@
 #include "pxr/usd/usd/primRange.h"
 #include "pxr/usd/usd/stagePopulationMask.h"
 
+#include <tbb/task_arena.h>
+
+#include <algorithm>
 #include <atomic>
+#include <thread>
 
 PXR_NAMESPACE_OPEN_SCOPE
 
@@ -81,6 +88,21 @@ TF_DEFINE_ENV_SETTING(GUSD_STAGEMASK_ENABLE, true,
                       "(or other types of stage edits).");
 
 
+TF_DEFINE_ENV_SETTING(GUSD_STAGECACHE_LOAD_CONCURRENCY, 0,
+                      "Maximum number of stages that may be opened "
+                      "concurrently when loading batches of prims from "
+                      "many different files. A value of 0 allows all "
+                      "available threads to open stages.");
+
+
+TF_DEFINE_ENV_SETTING(GUSD_STAGECACHE_MAX_MEMORY_MB, 0,
+                      "Initial memory budget, in megabytes, for stages held "
+                      "by a GusdStageCache. Least recently used stages that "
+                      "are not referenced outside of the cache are evicted "
+                      "once the budget is exceeded. A value of 0 disables "
+                      "eviction.");
+
+
 namespace {
 
 
@@ -226,7 +248,7 @@ struct _StageKeyHashCmp
                            _PointerTypesMatch(a.GetEdit(), b.GetEdit());
                 }
 
-    static bool hash(const _StageKey& key)
+    static size_t hash(const _StageKey& key)
                 {
                     size_t hash = SYShash(key.GetPath());
                     SYShashCombine(hash, key.GetOpts().GetHash());
@@ -237,6 +259,34 @@ struct _StageKeyHashCmp
 };
 
 
+struct _StageInfo;
+
+
+/// Immutable view of the unmasked stages on a cache.
+struct _StageSnapshot
+{
+    struct Hash
+    {
+        size_t  operator()(const _StageKey& key) const
+                { return _StageKeyHashCmp::hash(key); }
+    };
+
+    struct Equal
+    {
+        bool    operator()(const _StageKey& a, const _StageKey& b) const
+                { return _StageKeyHashCmp::equal(a, b); }
+    };
+
+    struct Entry
+    {
+        UsdStageRefPtr                  stage;
+        std::shared_ptr<_StageInfo>     info;
+    };
+
+    UT_Map<_StageKey,Entry,Hash,Equal>  map;
+};
+
+
 struct _SdfPathHashCmp
 {
     static bool     equal(const SdfPath& a, const SdfPath& b)
@@ -258,6 +308,140 @@ _IsValidPrimPath(const SdfPath& path)
 }
 
 
+/// Rough average footprint of a composed prim, including its prim index.
+/// Used to estimate stage memory, since USD cannot report it.
+constexpr int64 _EstimatedBytesPerPrim = 2048;
+
+/// Maximum number of eviction records kept for GetStats().
+constexpr exint _MaxEvictionHistory = 256;
+
+
+/// Book-keeping for the memory budget of a single cached stage.
+struct _StageInfo
+{
+    ~_StageInfo()   { TfNotice::Revoke(noticeKey); }
+
+    /// The stage is kept alive by the cache for as long as it's registered.
+    const UsdStage*     stage = nullptr;
+    UT_StringHolder     path;
+    std::atomic<int64>  memory {0};
+    bool                masked = false;
+    /// Pinned stages are owned externally and never evicted.
+    bool                pinned = false;
+    /// Set when the stage has changed since \c memory was estimated.
+    std::atomic<bool>   memoryDirty {false};
+    std::atomic<int64>  hits {0};
+    std::atomic<int64>  lastAccess {0};
+    /// Change notices for this stage only.
+    TfNotice::Key       noticeKey;
+};
+
+using _StageInfoPtr = std::shared_ptr<_StageInfo>;
+using _StageSet = UT_Set<const UsdStage*>;
+
+
+/// Estimate the memory held by \p stage.
+/// This traverses the whole stage, so estimates are only computed when
+/// the memory budget is checked, rather than when stages are opened.
+int64
+_EstimateStageMemory(const UsdStage& stage)
+{
+    const UsdPrimRange range = UsdPrimRange::AllPrims(stage.GetPseudoRoot());
+    const int64 numPrims = std::distance(range.begin(), range.end());
+    return sizeof(UsdStage) + numPrims*_EstimatedBytesPerPrim;
+}
+
+
+/// Publishes immutable snapshots of type T that can be read without locks.
+///
+/// Readers announce themselves in one of two sets of per-slot counters,
+/// chosen by the current phase. Retired snapshots are reclaimed by flipping
+/// the phase twice, waiting for each set of counters to drain in turn, after
+/// which no reader can still be looking at a retired snapshot. Readers only
+/// ever hold a snapshot for the duration of a lookup, so the waits are short.
+template <typename T>
+class _SnapshotDomain : UT_NonCopyable
+{
+    static constexpr int _NumSlots = 64;
+
+    /// Reader counts, aligned to a cache line to avoid false sharing.
+    struct alignas(64) _Slot
+    {
+        _Slot() { readers[0] = 0; readers[1] = 0; }
+
+        std::atomic<int64>  readers[2];
+    };
+
+public:
+    _SnapshotDomain() : _current(new T) {}
+
+    ~_SnapshotDomain()
+    {
+        delete _current.load();
+        for(const T* snapshot : _retired)
+            delete snapshot;
+    }
+
+    /// Scope within which the current snapshot may be read.
+    class ReadScope : UT_NonCopyable
+    {
+    public:
+        ReadScope(const _SnapshotDomain& domain)
+            : _slot(domain._slots[SYSgetSTID() % _NumSlots])
+            , _phase(domain._phase.load() & 1)
+        {
+            ++_slot.readers[_phase];
+            _snapshot = domain._current.load();
+        }
+
+        ~ReadScope()    { --_slot.readers[_phase]; }
+
+        const T&    operator*() const   { return *_snapshot; }
+        const T*    operator->() const  { return _snapshot; }
+
+    private:
+        _Slot&                              _slot;
+        const int                           _phase;
+        const T*                            _snapshot;
+    };
+
+    /// Lock that must be held while calling GetLocked() and Publish().
+    UT_Lock&    GetWriteLock()  { return _writeLock; }
+
+    /// Access the current snapshot. The write lock must be held.
+    const T&    GetLocked() const   { return *_current.load(); }
+
+    /// Replace the current snapshot, taking ownership of \p snapshot.
+    /// The write lock must be held.
+    void        Publish(const T* snapshot)
+                {
+                    _retired.append(_current.exchange(snapshot));
+                    _Reclaim();
+                }
+
+private:
+    void        _Reclaim()
+                {
+                    for(int flip = 0; flip < 2; ++flip) {
+                        const int oldPhase = _phase.fetch_add(1) & 1;
+                        for(const _Slot& slot : _slots) {
+                            while(slot.readers[oldPhase].load() != 0)
+                                std::this_thread::yield();
+                        }
+                    }
+                    for(const T* snapshot : _retired)
+                        delete snapshot;
+                    _retired.clear();
+                }
+
+    mutable _Slot           _slots[_NumSlots];
+    std::atomic<int>        _phase {0};
+    std::atomic<const T*>   _current;
+    UT_Array<const T*>      _retired;
+    UT_Lock                 _writeLock;
+};
+
+
 } /*namespace*/
 
 
@@ -288,6 +472,17 @@ public:
                             stages.insert(pair.second);
                     }
 
+    /// Count the references to each stage held by this cache.
+    void            CountStageRefs(UT_Map<const UsdStage*,exint>& refs) const
+                    {
+                        for(const auto& pair : _map)
+                            ++refs[get_pointer(pair.second)];
+                    }
+
+    /// Remove all entries referencing any of \p stages.
+    /// Returns true if the cache is empty afterwards.
+    bool            RemoveStages(const _StageSet& stages);
+
     /// Load a range of [start,end) prims from this cache. The range corresponds
     /// to a *subset* of the prims in \p primPaths.
     /// The \p rangeFn functor must implement `operator()(exint)` which, given
@@ -312,6 +507,8 @@ private:
 
     SdfPath _GetDefaultPrimPath(UT_ErrorSeverity sev=UT_ERROR_ABORT) const;
 
+    UsdStageRefPtr  _FindStage(const SdfPath& primPath);
+
 private:
     using _StageMap = UT_ConcurrentHashMap<SdfPath,UsdStageRefPtr,
                                            _SdfPathHashCmp>;
@@ -323,13 +520,28 @@ private:
 
 
 /// Primary internal cache implementation.
-class GusdStageCache::_Impl
+class GusdStageCache::_Impl : public TfWeakBase // Required for TfNotice
 {
 public:
+    _Impl();
     ~_Impl();
 
     UT_RWLock&      GetMapLock()    { return _mapLock; }
 
+    /// Acquire or release the exclusive map lock for a writer.
+    /// The write epoch is odd while a writer holds the lock, which keeps
+    /// lock-free lookups from returning stages the writer is changing.
+    void            BeginWrite()
+                    {
+                        _mapLock.writeLock();
+                        ++_writeEpoch;
+                    }
+    void            EndWrite()
+                    {
+                        ++_writeEpoch;
+                        _mapLock.writeUnlock();
+                    }
+
     /// Methods accessible to GusdStageCacheReader.
     /// These require only a shared lock to the stage.
 
@@ -425,6 +637,46 @@ public:
     void            FindStages(const UT_StringSet& paths,
                                UT_Set<UsdStageRefPtr>& stages) const;
 
+    /// Memory budget and statistics.
+    /// Eviction and statistics queries require an exclusive lock.
+
+    void            SetMaxMemory(int64 bytes)   { _maxMemory = bytes; }
+    int64           GetMaxMemory() const        { return _maxMemory; }
+
+    bool            IsOverBudget() const
+                    {
+                        const int64 maxMemory = _maxMemory;
+                        return maxMemory > 0 && _memory > maxMemory;
+                    }
+
+    void            EvictToBudget(bool propagateDirty=false);
+
+    /// Evict stages if over budget, provided this is the main thread
+    /// and no other accessor holds the map lock.
+    void            EvictIfOverBudget();
+
+    void            GetStats(GusdStageCache::Stats& stats);
+
+    /// Re-estimate the memory of stages that changed since their last
+    /// estimate. Requires a shared or exclusive map lock, which keeps
+    /// the dirty stages alive while they are traversed.
+    void            UpdateMemoryEstimates();
+
+    /// Record a cache hit for \p stage.
+    void            TouchStage(const UsdStageRefPtr& stage) const;
+
+    /// Look up an unmasked stage without taking any locks.
+    /// This may miss stages that are in the process of being inserted,
+    /// or that have not been published yet. It always misses while a
+    /// writer holds the map lock, so that callers fall back to waiting
+    /// on the lock.
+    UsdStageRefPtr  FindStageInSnapshot(const UT_StringRef& path,
+                                        const GusdStageOpts& opts,
+                                        const GusdStageEditPtr& edit) const;
+
+    /// Publish any stages inserted since the last snapshot.
+    void            FlushSnapshot();
+
     void            InsertStage(UsdStageRefPtr &stage,
                                 const UT_StringRef& path,
                                 const GusdStageOpts& opts,
@@ -460,6 +712,46 @@ protected:
     /// Expand the set of masked prims on a stage.
     void            _ExpandStageMask(UsdStageRefPtr& stage);
 
+    /// Start tracking memory and access statistics for \p stage.
+    void            _RegisterStage(const UsdStageRefPtr& stage,
+                                   const UT_StringRef& path,
+                                   bool masked, bool pinned);
+
+    /// Stop tracking \p stages, removing their contribution to the
+    /// memory budget.
+    void            _UnregisterStages(const _StageSet& stages);
+
+    /// Flag the memory estimate of \p info as out of date.
+    void            _DirtyMemory(const _StageInfoPtr& info);
+
+    /// Stages may grow after they are opened, e.g. by loading payloads.
+    void            _HandleStageContentsChanged(
+                        const UsdNotice::StageContentsChanged& n);
+
+    /// Remove \p stages from the cache, dirtying their micro nodes.
+    void            _RemoveStages(const _StageSet& stages,
+                                  bool propagateDirty);
+
+    /// Add a new entry for \p stage on the unmasked stage map to the
+    /// lock-free snapshot. Entries are batched, and only published once
+    /// enough have accumulated to make copying the snapshot worthwhile,
+    /// or when FlushSnapshot() is called.
+    void            _PublishStage(const _StageKey& key,
+                                  const UsdStageRefPtr& stage);
+
+    /// Publish the batched entries. The snapshot write lock must be held.
+    void            _PublishPendingLocked();
+
+    /// Rebuild the lock-free snapshot from the unmasked stage map.
+    /// Requires an exclusive map lock.
+    void            _RebuildSnapshot();
+
+    /// Insert \p stage on the unmasked stage map, if no entry exists.
+    void            _InsertFullStage(const _StageKey& key,
+                                     const UsdStageRefPtr& stage);
+
+    static void     _Touch(_StageInfo& info, int64 clock);
+
     /// Get a range of prims from \p stage, using the same range
     /// encoding as LoadPrimRange.
     template <typename PrimRangeFn>
@@ -484,7 +776,7 @@ private:
         static bool equal(const UsdStagePtr& a, const UsdStagePtr& b)
                     { return a == b; }
 
-        static bool hash(const UsdStagePtr& stage)
+        static size_t hash(const UsdStagePtr& stage)
                     { return SYShash(stage); }
     };
 
@@ -494,9 +786,14 @@ private:
                              std::shared_ptr<_StageChangeMicroNode>,
                              _StageHashCmp>;
 
+    using _StageInfoMap = UT_ConcurrentHashMap<const UsdStage*,
+                                               _StageInfoPtr>;
+
     /// Mutex around the concurrent maps.
     /// An exclusive lock must be acquired when iterating over the maps.
     UT_RWLock   _mapLock;
+    /// Incremented by BeginWrite() and EndWrite().
+    std::atomic<int64> _writeEpoch {0};
 
     /// Data cache mutex.
     /// Must be acquired when accessing data caches in any way.  
@@ -504,6 +801,11 @@ private:
 
     /// Cache of stages without any masks.
     _StageMap   _stageMap;
+    /// Immutable copies of _stageMap, for lock-free lookups.
+    _SnapshotDomain<_StageSnapshot> _snapshots;
+    /// Entries waiting to be added to the snapshot.
+    /// Guarded by the snapshot write lock.
+    UT_Array<std::pair<_StageKey,_StageSnapshot::Entry> > _pendingSnapshot;
     /// Cache of sub-caches for masked stages.
     _MaskedStageCacheMap _maskedCacheMap;
 
@@ -511,9 +813,28 @@ private:
     _MicroNodeMap _microNodeMap;
     
     UT_Array<GusdUSD_DataCache*> _dataCaches;
+
+    /// Memory budget book-keeping, keyed by stage.
+    _StageInfoMap               _stageInfoMap;
+    std::atomic<int64>          _maxMemory;
+    std::atomic<int64>          _memory {0};
+    std::atomic<int64>          _numDirtyMemory {0};
+    /// Stages whose memory estimate is out of date.
+    UT_Array<_StageInfoPtr>     _dirtyMemory;
+    UT_Lock                     _dirtyMemoryLock;
+    std::atomic<int64>          _accessClock {0};
+    std::atomic<int64>          _misses {0};
+    int64                       _numEvicted = 0;
+    UT_Array<GusdStageCache::EvictionRecord> _evictionHistory;
 };
 
 
+GusdStageCache::_Impl::_Impl()
+    : _maxMemory(int64(TfGetEnvSetting(GUSD_STAGECACHE_MAX_MEMORY_MB))
+                 * 1024 * 1024)
+{}
+
+
 GusdStageCache::_Impl::~_Impl()
 {
     // Clear entries, but don't propagate dirty states, as we
@@ -569,6 +890,10 @@ GusdStageCache::_Impl::OpenNewStage(const UT_StringRef& path,
 
             if(mask)
                 _ExpandStageMask(stage);
+
+            ++_misses;
+            _RegisterStage(stage, path, /*masked*/ mask != nullptr,
+                           /*pinned*/ false);
             return stage;
         } else {
             GUSD_GENERIC_ERR(sev).Msg(
@@ -783,13 +1108,133 @@ GusdStageCache::_Impl::FindStage(const UT_StringRef& path,
     // XXX: empty paths should be caught earlier.
     UT_ASSERT_P(path);
 
+    if(UsdStageRefPtr stage = FindStageInSnapshot(path, opts, edit))
+        return stage;
+
+    // The stage may have been inserted but not yet published.
     _StageMap::const_accessor a;
-    if(_stageMap.find(a, _StageKey(UTmakeUnsafeRef(path), opts, edit)))
+    if(_stageMap.find(a, _StageKey(UTmakeUnsafeRef(path), opts, edit))) {
+        TouchStage(a->second);
         return a->second;
+    }
     return TfNullPtr;
 }
 
 
+UsdStageRefPtr
+GusdStageCache::_Impl::FindStageInSnapshot(const UT_StringRef& path,
+                                           const GusdStageOpts& opts,
+                                           const GusdStageEditPtr& edit) const
+{
+    UT_ASSERT_P(path);
+
+    const int64 epoch = _writeEpoch.load(std::memory_order_acquire);
+    if(epoch & 1)
+        return TfNullPtr;
+
+    _SnapshotDomain<_StageSnapshot>::ReadScope snapshot(_snapshots);
+
+    auto it = snapshot->map.find(_StageKey(UTmakeUnsafeRef(path), opts, edit));
+    if(it != snapshot->map.end()) {
+        // Discard the hit if a writer started while looking it up.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(_writeEpoch.load(std::memory_order_relaxed) != epoch)
+            return TfNullPtr;
+
+        if(it->second.info) {
+            _Touch(*it->second.info,
+                   _accessClock.load(std::memory_order_relaxed));
+        }
+        return it->second.stage;
+    }
+    return TfNullPtr;
+}
+
+
+void
+GusdStageCache::_Impl::_PublishStage(const _StageKey& key,
+                                     const UsdStageRefPtr& stage)
+{
+    _StageInfoPtr info;
+    {
+        _StageInfoMap::const_accessor a;
+        if(_stageInfoMap.find(a, get_pointer(stage)))
+            info = a->second;
+    }
+
+    UT_AutoLock lock(_snapshots.GetWriteLock());
+
+    _pendingSnapshot.append(
+        std::make_pair(key, _StageSnapshot::Entry{ stage, info }));
+
+    // Every publish copies the snapshot, so wait until the batch is a
+    // sizable fraction of it. This keeps the total cost of building up
+    // the snapshot linear in the number of stages.
+    if(_pendingSnapshot.size()*2 > exint(_snapshots.GetLocked().map.size()))
+        _PublishPendingLocked();
+}
+
+
+void
+GusdStageCache::_Impl::_PublishPendingLocked()
+{
+    if(_pendingSnapshot.isEmpty())
+        return;
+
+    auto* snapshot = new _StageSnapshot(_snapshots.GetLocked());
+    for(const auto& pair : _pendingSnapshot)
+        snapshot->map[pair.first] = pair.second;
+    _pendingSnapshot.clear();
+    _snapshots.Publish(snapshot);
+}
+
+
+void
+GusdStageCache::_Impl::FlushSnapshot()
+{
+    UT_AutoLock lock(_snapshots.GetWriteLock());
+    _PublishPendingLocked();
+}
+
+
+void
+GusdStageCache::_Impl::_RebuildSnapshot()
+{
+    // XXX: Caller should have an exclusive map lock!
+
+    auto* snapshot = new _StageSnapshot;
+    for(const auto& pair : _stageMap) {
+        _StageInfoPtr info;
+        _StageInfoMap::const_accessor a;
+        if(_stageInfoMap.find(a, get_pointer(pair.second)))
+            info = a->second;
+        snapshot->map[pair.first] = { pair.second, info };
+    }
+
+    // The stage map already holds any pending entries.
+    UT_AutoLock lock(_snapshots.GetWriteLock());
+    _pendingSnapshot.clear();
+    _snapshots.Publish(snapshot);
+}
+
+
+void
+GusdStageCache::_Impl::_InsertFullStage(const _StageKey& key,
+                                        const UsdStageRefPtr& stage)
+{
+    bool inserted = false;
+    {
+        _StageMap::accessor a;
+        if(_stageMap.insert(a, key)) {
+            a->second = stage;
+            inserted = true;
+        }
+    }
+    if(inserted)
+        _PublishStage(key, stage);
+}
+
+
 UsdStageRefPtr
 GusdStageCache::_Impl::FindOrOpenStage(const UT_StringRef& path,
                                        const GusdStageOpts& opts,
@@ -809,8 +1254,14 @@ GusdStageCache::_Impl::FindOrOpenStage(const UT_StringRef& path,
         "[GusdStageCache::FindOrOpenStage] Cache miss for @%s@\n",
         path.c_str());
 
-    _StageMap::accessor a;
-    if(_stageMap.insert(a, _StageKey(path, opts, edit))) {
+    _StageKey key(path, opts, edit);
+    UsdStageRefPtr stage;
+    {
+        _StageMap::accessor a;
+        if(!_stageMap.insert(a, key)) {
+            // Another thread opened the stage first.
+            return a->second;
+        }
 
         a->second = OpenNewStage(path, opts, edit, /*mask*/ nullptr, sev);
 
@@ -822,8 +1273,10 @@ GusdStageCache::_Impl::FindOrOpenStage(const UT_StringRef& path,
             _stageMap.erase(a);
             return TfNullPtr;
         }
+        stage = a->second;
     }
-    return a->second;
+    _PublishStage(key, stage);
+    return stage;
 }
 
 
@@ -874,11 +1327,7 @@ GusdStageCache::_Impl::FindOrOpenMaskedStage(const UT_StringRef& path,
                 // Despite trying to load a masked stage, the entire stage
                 // has been loaded. Store this stage on the non-masked stage
                 // map so that all future cache lookups will find it.
-                _StageMap::accessor stageMapAcc;
-                if (_stageMap.insert(
-                        stageMapAcc, _StageKey(path, opts, edit))) {
-                    stageMapAcc->second = stage;
-                }
+                _InsertFullStage(_StageKey(path, opts, edit), stage);
             }
 
             return stage;
@@ -906,10 +1355,7 @@ GusdStageCache::_Impl::FindOrOpenMaskedStage(const UT_StringRef& path,
 
     if (loadedFullStage) {
         // Same case as above.
-        _StageMap::accessor stageMapAcc;
-        if (_stageMap.insert(stageMapAcc, _StageKey(path, opts, edit))) {
-            stageMapAcc->second = stage;
-        }
+        _InsertFullStage(_StageKey(path, opts, edit), stage);
     }
     return stage;
 }
@@ -1130,6 +1576,74 @@ _PrimLoadRange::ComputeSharedStageRanges(
 }
 
 
+/// Run \p fn, limiting the number of threads it may use to the
+/// GUSD_STAGECACHE_LOAD_CONCURRENCY setting.
+template <typename Fn>
+void
+_RunWithLoadConcurrency(const Fn& fn)
+{
+    const int limit = TfGetEnvSetting(GUSD_STAGECACHE_LOAD_CONCURRENCY);
+    if(limit > 0 && limit < UT_Thread::getNumProcessors()) {
+        tbb::task_arena arena(limit);
+        arena.execute(fn);
+    } else {
+        fn();
+    }
+}
+
+
+/// Concurrently read the root layers of all files referenced by
+/// \p ranges, storing them in \p layers.
+void
+_PrefetchRootLayers(const _PrimLoadRange& primRange,
+                    const UT_Array<std::pair<exint,exint> >& ranges,
+                    UT_Array<SdfLayerRefPtr>& layers)
+{
+    // Ranges are sorted by path, so unique paths are contiguous.
+    UT_Array<UT_StringHolder> uniquePaths;
+    for(const auto& range : ranges) {
+        const UT_StringHolder& path = primRange.keys(range.first).path;
+        if(uniquePaths.isEmpty() || uniquePaths.last() != path) {
+            uniquePaths.append(path);
+        }
+    }
+    if(uniquePaths.size() < 2) {
+        // Nothing to overlap.
+        return;
+    }
+
+    layers.setSize(uniquePaths.size());
+
+    // Resolver contexts are bound per thread, so forward the
+    // caller's context to the workers.
+    const ArResolverContext resolverContext =
+        ArGetResolver().GetCurrentContext();
+
+    _RunWithLoadConcurrency(
+        [&]()
+        {
+            UTparallelForEachNumber(
+                uniquePaths.size(),
+                [&](const UT_BlockedRange<exint>& r)
+                {
+                    ArResolverContextBinder binder(resolverContext);
+                    auto* boss = UTgetInterrupt();
+
+                    for(exint i = r.begin(); i < r.end(); ++i) {
+                        if(ARCH_UNLIKELY(boss->opInterrupt())) {
+                            return;
+                        }
+                        // Errors are reported when the stage itself is
+                        // opened, so keep this quiet.
+                        GusdTfErrorScope errorScope(UT_ERROR_NONE);
+                        layers[i] = SdfLayer::FindOrOpen(
+                            uniquePaths(i).toStdString());
+                    }
+                });
+        });
+}
+
+
 } // namespace
 
 
@@ -1186,38 +1700,69 @@ GusdStageCache::_Impl::LoadPrims(
 
     // We now have contiguous ranges of prims, identifying which
     // prims can be loaded on the same stage.
-    // Dispatch across these ranges to load prims.
+
+    // Read the root layers of all referenced files concurrently before
+    // composing any stages. Layer reads dominate load times when prims
+    // are pulled from many files, and holding the layers here keeps them
+    // alive until the stages that use them have been opened.
+    UT_Array<SdfLayerRefPtr> rootLayers;
+    _PrefetchRootLayers(primRange, ranges, rootLayers);
+
+    // Dispatch the largest ranges first, so that the stage with the most
+    // prims to bind doesn't end up at the tail of the load.
+    UT_Array<exint> rangeOrder;
+    rangeOrder.setSizeNoInit(ranges.size());
+    for(exint i = 0; i < ranges.size(); ++i) {
+        rangeOrder[i] = i;
+    }
+    std::stable_sort(rangeOrder.begin(), rangeOrder.end(),
+                     [&](exint a, exint b)
+                     {
+                         return (ranges(a).second - ranges(a).first) >
+                                (ranges(b).second - ranges(b).first);
+                     });
+
+    // Each range opens and composes its stage, then binds its prims as
+    // soon as that stage is available. Ranges are handed out one at a
+    // time so that a slow stage does not hold up a batch of others.
 
     std::atomic_bool workerInterrupt(false);
 
     GusdErrorTransport errTransport;
 
-    UTparallelFor(
-        UT_BlockedRange<size_t>(0, ranges.size()),
-        [&](const UT_BlockedRange<size_t>& r)
+    _RunWithLoadConcurrency(
+        [&]()
         {
-            GusdAutoErrorTransport autoErrTransport(errTransport);
+            UTparallelForEachNumber(
+                rangeOrder.size(),
+                [&](const UT_BlockedRange<exint>& r)
+                {
+                    GusdAutoErrorTransport autoErrTransport(errTransport);
 
-            auto* boss = UTgetInterrupt();
+                    auto* boss = UTgetInterrupt();
             
-            for(size_t i = r.begin(); i < r.end(); ++i) {
-                if(ARCH_UNLIKELY(boss->opInterrupt() || workerInterrupt)) {
-                    return;
-                }
+                    for(exint i = r.begin(); i < r.end(); ++i) {
+                        if(ARCH_UNLIKELY(boss->opInterrupt() ||
+                                         workerInterrupt)) {
+                            return;
+                        }
 
-                const auto& range = ranges(i);
+                        const auto& range = ranges(rangeOrder(i));
                 
-                // Can get the file/edit from the first key in the range.
-                const auto& key = primRange.keys(range.first);
-
-                if(!LoadPrimRange(primRange, range.first, range.second,
-                                  key.path, opts, key.edit,
-                                  primPaths, prims, sev)) {
-                    // Interrupt the other worker threads.
-                    workerInterrupt = true;
-                    break;
-                }
-            }
+                        // Can get the file/edit from the first key
+                        // in the range.
+                        const auto& key = primRange.keys(range.first);
+
+                        if(!LoadPrimRange(primRange,
+                                          range.first, range.second,
+                                          key.path, opts, key.edit,
+                                          primPaths, prims, sev)) {
+                            // Interrupt the other worker threads.
+                            workerInterrupt = true;
+                            break;
+                        }
+                    }
+                });
         });
     
     return !task.wasInterrupted() && !workerInterrupt;
@@ -1286,6 +1831,7 @@ GusdStageCache::_Impl::Clear(bool propagateDirty)
     // XXX: Caller should have an exclusive map lock!
     
     _stageMap.clear();
+    _RebuildSnapshot();
 
     for(auto& pair : _maskedCacheMap)
         delete pair.second;
@@ -1306,6 +1852,14 @@ GusdStageCache::_Impl::Clear(bool propagateDirty)
         }
     }
     _microNodeMap.clear();
+
+    {
+        UT_AutoLock lock(_dirtyMemoryLock);
+        _dirtyMemory.clear();
+    }
+    _stageInfoMap.clear();
+    _memory = 0;
+    _numDirtyMemory = 0;
 }
 
 
@@ -1325,6 +1879,7 @@ GusdStageCache::_Impl::Clear(const UT_StringSet& paths, bool propagateDirty)
     }
     for(const auto& key : keysToRemove)
         _stageMap.erase(key);
+    _RebuildSnapshot();
 
     keysToRemove.clear();
     for(auto& pair : _maskedCacheMap) {
@@ -1349,6 +1904,10 @@ GusdStageCache::_Impl::Clear(const UT_StringSet& paths, bool propagateDirty)
         _microNodeMap.erase(stage);
     }
 
+    _StageSet stagePtrs;
+    for(const UsdStageRefPtr& stage : stagesBeingRemoved)
+        stagePtrs.insert(get_pointer(stage));
+    _UnregisterStages(stagePtrs);
 
     {
         UT_AutoLock lock(_dataCacheLock);
@@ -1390,15 +1949,355 @@ GusdStageCache::_Impl::InsertStage(UsdStageRefPtr &stage,
         "[GusdStageCache::InsertStage] Inserting stage @%s@\n",
         path.c_str());
 
-    _StageMap::accessor a;
-    if(stage && _stageMap.insert(a, _StageKey(path, opts, edit))) {
-        a->second = stage;
+    if(!stage)
+        return;
+
+    _RegisterStage(stage, path, /*masked*/ false, /*pinned*/ true);
+    _InsertFullStage(_StageKey(path, opts, edit), stage);
+}
+
+
+void
+GusdStageCache::_Impl::_RegisterStage(const UsdStageRefPtr& stage,
+                                      const UT_StringRef& path,
+                                      bool masked, bool pinned)
+{
+    _StageInfoMap::accessor a;
+    if(_stageInfoMap.insert(a, get_pointer(stage))) {
+        auto info = std::make_shared<_StageInfo>();
+        info->stage = get_pointer(stage);
+        info->path = path;
+        info->masked = masked;
+        info->pinned = pinned;
+        info->lastAccess = ++_accessClock;
+        a->second = info;
+
+        // The memory is estimated on demand by UpdateMemoryEstimates().
+        if(!pinned) {
+            // Stages may grow after they are opened, e.g. by loading
+            // payloads, so listen for changes to this stage.
+            info->noticeKey = TfNotice::Register(
+                TfCreateWeakPtr(this), &_Impl::_HandleStageContentsChanged,
+                UsdStagePtr(stage));
+            _DirtyMemory(info);
+        }
+    } else if(pinned) {
+        // A stage we opened is now externally owned.
+        if(a->second->memoryDirty.exchange(false))
+            --_numDirtyMemory;
+        _memory -= a->second->memory;
+        a->second->memory = 0;
+        a->second->pinned = true;
+        TfNotice::Revoke(a->second->noticeKey);
+    }
+}
+
+
+void
+GusdStageCache::_Impl::_UnregisterStages(const _StageSet& stages)
+{
+    for(const UsdStage* stage : stages) {
+        _StageInfoMap::accessor a;
+        if(_stageInfoMap.find(a, stage)) {
+            if(a->second->memoryDirty.exchange(false))
+                --_numDirtyMemory;
+            _memory -= a->second->memory;
+            TfNotice::Revoke(a->second->noticeKey);
+            _stageInfoMap.erase(a);
+        }
+    }
+}
+
+
+void
+GusdStageCache::_Impl::_DirtyMemory(const _StageInfoPtr& info)
+{
+    if(!info->pinned && !info->memoryDirty.exchange(true)) {
+        ++_numDirtyMemory;
+
+        UT_AutoLock lock(_dirtyMemoryLock);
+        _dirtyMemory.append(info);
+    }
+}
+
+
+void
+GusdStageCache::_Impl::UpdateMemoryEstimates()
+{
+    // XXX: Caller should have a shared or exclusive map lock!
+    //      Stages are only unregistered under an exclusive lock, and
+    //      unregistering clears the dirty flag, so the stages of
+    //      dirty entries remain alive while they are traversed.
+
+    if(_numDirtyMemory == 0)
+        return;
+
+    UT_Array<_StageInfoPtr> dirty;
+    {
+        UT_AutoLock lock(_dirtyMemoryLock);
+        dirty.swap(_dirtyMemory);
+    }
+
+    for(const _StageInfoPtr& info : dirty) {
+        if(!info->memoryDirty.exchange(false))
+            continue;
+        --_numDirtyMemory;
+
+        const int64 memory = _EstimateStageMemory(*info->stage);
+        _memory += memory - info->memory.exchange(memory);
     }
 }
 
 
+void
+GusdStageCache::_Impl::_HandleStageContentsChanged(
+    const UsdNotice::StageContentsChanged& n)
+{
+    // Only sent for registered stages. Just flag the estimate, since
+    // this is typically on the main thread.
+    const UsdStageWeakPtr& stage = n.GetStage();
+    if(!stage)
+        return;
+
+    _StageInfoMap::const_accessor a;
+    if(_stageInfoMap.find(a, get_pointer(stage)))
+        _DirtyMemory(a->second);
+}
+
+
+void
+GusdStageCache::_Impl::_Touch(_StageInfo& info, int64 clock)
+{
+    // Keep this cheap, since it's on the lock-free lookup path:
+    // The access clock only advances when stages are opened, so hot
+    // stages rarely need to write their access stamp.
+    info.hits.fetch_add(1, std::memory_order_relaxed);
+    if(info.lastAccess.load(std::memory_order_relaxed) != clock)
+        info.lastAccess.store(clock, std::memory_order_relaxed);
+}
+
+
+void
+GusdStageCache::_Impl::TouchStage(const UsdStageRefPtr& stage) const
+{
+    _StageInfoMap::const_accessor a;
+    if(_stageInfoMap.find(a, get_pointer(stage)))
+        _Touch(*a->second, _accessClock.load(std::memory_order_relaxed));
+}
+
+
+void
+GusdStageCache::_Impl::_RemoveStages(const _StageSet& stages,
+                                     bool propagateDirty)
+{
+    // XXX: Caller should have an exclusive map lock!
+
+    UT_Array<_StageKey> keysToRemove;
+    for(const auto& pair : _stageMap) {
+        if(stages.contains(get_pointer(pair.second)))
+            keysToRemove.append(pair.first);
+    }
+    for(const auto& key : keysToRemove)
+        _stageMap.erase(key);
+    _RebuildSnapshot();
+
+    keysToRemove.clear();
+    for(auto& pair : _maskedCacheMap) {
+        if(pair.second->RemoveStages(stages)) {
+            keysToRemove.append(pair.first);
+            delete pair.second;
+        }
+    }
+    for(const auto& key : keysToRemove)
+        _maskedCacheMap.erase(key);
+
+    UT_Array<UsdStagePtr> microNodeKeys;
+    for(auto& pair : _microNodeMap) {
+        if(stages.contains(get_pointer(pair.first))) {
+            if(propagateDirty)
+                pair.second->SetDirty();
+            microNodeKeys.append(pair.first);
+        }
+    }
+    for(const auto& key : microNodeKeys)
+        _microNodeMap.erase(key);
+
+    _UnregisterStages(stages);
+}
+
+
+void
+GusdStageCache::_Impl::EvictToBudget(bool propagateDirty)
+{
+    // XXX: Caller should have an exclusive map lock!
+
+    // Estimates are updated by the callers, so that stages aren't
+    // traversed while holding the exclusive lock on every release of
+    // an accessor.
+    if(!IsOverBudget())
+        return;
+
+    // A stage is only referenced outside of the cache if it has more
+    // references than the cache itself holds.
+    UT_Map<const UsdStage*,exint> cacheRefs;
+    for(const auto& pair : _stageMap)
+        ++cacheRefs[get_pointer(pair.second)];
+    for(const auto& pair : _maskedCacheMap)
+        pair.second->CountStageRefs(cacheRefs);
+    {
+        UT_AutoLock lock(_snapshots.GetWriteLock());
+        for(const auto& pair : _snapshots.GetLocked().map)
+            ++cacheRefs[get_pointer(pair.second.stage)];
+        for(const auto& pair : _pendingSnapshot)
+            ++cacheRefs[get_pointer(pair.second.stage)];
+    }
+
+    UT_Array<std::pair<const UsdStage*,_StageInfoPtr> > candidates;
+    for(const auto& pair : _stageInfoMap) {
+        const _StageInfoPtr& info = pair.second;
+        if(info->pinned)
+            continue;
+        auto it = cacheRefs.find(pair.first);
+        if(it != cacheRefs.end() &&
+           pair.first->GetCurrentCount() <= size_t(it->second)) {
+            candidates.emplace_back(pair.first, info);
+        }
+    }
+
+    // Least recently used first.
+    std::sort(candidates.begin(), candidates.end(),
+              [](const std::pair<const UsdStage*,_StageInfoPtr>& a,
+                 const std::pair<const UsdStage*,_StageInfoPtr>& b)
+              { return a.second->lastAccess < b.second->lastAccess; });
+
+    const int64 maxMemory = _maxMemory;
+    int64 memory = _memory;
+
+    _StageSet stagesToEvict;
+    UT_StringSet pathsToClear;
+    for(const auto& candidate : candidates) {
+        if(memory <= maxMemory)
+            break;
+
+        const _StageInfo& info = *candidate.second;
+
+        TF_DEBUG(GUSD_STAGECACHE).Msg(
+            "[GusdStageCache] Evicting %sstage @%s@ (%lld bytes)\n",
+            info.masked ? "masked " : "", info.path.c_str(),
+            (long long)info.memory);
+
+        stagesToEvict.insert(candidate.first);
+        pathsToClear.insert(info.path);
+        memory -= info.memory;
+
+        GusdStageCache::EvictionRecord record;
+        record.path = info.path;
+        record.memory = info.memory;
+        record.masked = info.masked;
+        if(_evictionHistory.size() >= _MaxEvictionHistory)
+            _evictionHistory.removeIndex(0);
+        _evictionHistory.append(record);
+        ++_numEvicted;
+    }
+
+    if(stagesToEvict.empty())
+        return;
+
+    _RemoveStages(stagesToEvict, propagateDirty);
+
+    {
+        UT_AutoLock lock(_dataCacheLock);
+        for(auto* cache : _dataCaches) {
+            UT_ASSERT_P(cache);
+            cache->Clear(pathsToClear);
+        }
+    }
+}
+
+
+void
+GusdStageCache::_Impl::EvictIfOverBudget()
+{
+    // Dirty propagation, and with it eviction, is only safe on the
+    // main thread. Don't wait on other accessors; eviction will be
+    // attempted again when the next accessor is released.
+    if(_maxMemory <= 0 || !UT_Thread::isMainThread())
+        return;
+
+    // Estimate with a shared lock, so that other readers may proceed
+    // while the changed stages are traversed.
+    if(_numDirtyMemory > 0 && _mapLock.tryReadLock()) {
+        UpdateMemoryEstimates();
+        _mapLock.readUnlock();
+    }
+    if(!IsOverBudget())
+        return;
+
+    if(_mapLock.tryWriteLock()) {
+        EvictToBudget(/*propagateDirty*/ true);
+        _mapLock.writeUnlock();
+    }
+}
+
+
+void
+GusdStageCache::_Impl::GetStats(GusdStageCache::Stats& stats)
+{
+    // XXX: Caller should have an exclusive map lock!
+
+    // Estimates are otherwise only kept up to date while a budget is set.
+    UpdateMemoryEstimates();
+
+    stats.stages.clear();
+    stats.stages.setCapacity(_stageInfoMap.size());
+    for(const auto& pair : _stageInfoMap) {
+        const _StageInfo& info = *pair.second;
+
+        GusdStageCache::StageStats stageStats;
+        stageStats.path = info.path;
+        stageStats.memory = info.memory;
+        stageStats.hits = info.hits;
+        stageStats.masked = info.masked;
+        stageStats.pinned = info.pinned;
+        stats.stages.append(stageStats);
+    }
+    stats.evictions = _evictionHistory;
+    stats.hits = 0;
+    for(const auto& stageStats : stats.stages)
+        stats.hits += stageStats.hits;
+    stats.misses = _misses;
+    stats.numEvicted = _numEvicted;
+    stats.memory = _memory;
+    stats.maxMemory = _maxMemory;
+}
+
+
 UsdStageRefPtr
 GusdStageCache::_MaskedStageCache::FindStage(const SdfPath& primPath)
+{
+    UsdStageRefPtr stage = _FindStage(primPath);
+    if(stage)
+        _stageCache.TouchStage(stage);
+    return stage;
+}
+
+
+bool
+GusdStageCache::_MaskedStageCache::RemoveStages(const _StageSet& stages)
+{
+    UT_Array<SdfPath> keysToRemove;
+    for(const auto& pair : _map) {
+        if(stages.contains(get_pointer(pair.second)))
+            keysToRemove.append(pair.first);
+    }
+    for(const auto& key : keysToRemove)
+        _map.erase(key);
+    return _map.empty();
+}
+
+
+UsdStageRefPtr
+GusdStageCache::_MaskedStageCache::_FindStage(const SdfPath& primPath)
 {
     UT_ASSERT_P(_IsValidPrimPath(primPath));
 
@@ -1698,22 +2597,55 @@ GusdStageCache::RemoveDataCache(GusdUSD_DataCache& cache)
 }
 
 
+void
+GusdStageCache::SetMaxMemory(int64 bytes)
+{
+    _impl->SetMaxMemory(bytes);
+}
+
+
+int64
+GusdStageCache::GetMaxMemory() const
+{
+    return _impl->GetMaxMemory();
+}
+
+
 GusdStageCacheReader::GusdStageCacheReader(GusdStageCache& cache, bool writer)
-    : _cache(cache), _writer(writer)
+    : _cache(cache), _writer(writer), _locked(writer)
 {
+    // Readers lock on demand; see _Lock().
     if(writer)
-        _cache._impl->GetMapLock().writeLock();
-    else
-        _cache._impl->GetMapLock().readLock();
+        _cache._impl->BeginWrite();
+}
+
+
+void
+GusdStageCacheReader::_Lock() const
+{
+    std::call_once(_lockOnce, [this]()
+    {
+        if(!_locked) {
+            _cache._impl->GetMapLock().readLock();
+            _locked = true;
+        }
+    });
 }
 
 
 GusdStageCacheReader::~GusdStageCacheReader()
 {
-    if(_writer)
-        _cache._impl->GetMapLock().writeUnlock();
-    else
+    if(_writer) {
+        _cache._impl->EndWrite();
+        _cache._impl->FlushSnapshot();
+        _cache._impl->EvictIfOverBudget();
+    } else if(_locked) {
         _cache._impl->GetMapLock().readUnlock();
+        // Make the stages this reader opened visible to lock-free lookups.
+        _cache._impl->FlushSnapshot();
+        // Readers may have inserted new stages.
+        _cache._impl->EvictIfOverBudget();
+    }
 }
 
 
@@ -1722,7 +2654,15 @@ GusdStageCacheReader::Find(const UT_StringRef& path,
                            const GusdStageOpts& opts,
                            const GusdStageEditPtr& edit) const
 {
-    return path ? _cache._impl->FindStage(path, opts, edit) : TfNullPtr;
+    if(!path)
+        return TfNullPtr;
+
+    if(UsdStageRefPtr stage =
+       _cache._impl->FindStageInSnapshot(path, opts, edit)) {
+        return stage;
+    }
+    _Lock();
+    return _cache._impl->FindStage(path, opts, edit);
 }
 
 
@@ -1732,14 +2672,22 @@ GusdStageCacheReader::FindOrOpen(const UT_StringRef& path,
                                  const GusdStageEditPtr& edit,
                                  UT_ErrorSeverity sev)
 {
-    return path ? _cache._impl->FindOrOpenStage(
-        path, opts, edit, sev) : TfNullPtr;
+    if(!path)
+        return TfNullPtr;
+
+    if(UsdStageRefPtr stage =
+       _cache._impl->FindStageInSnapshot(path, opts, edit)) {
+        return stage;
+    }
+    _Lock();
+    return _cache._impl->FindOrOpenStage(path, opts, edit, sev);
 }
 
 
 DEP_MicroNode*
 GusdStageCacheReader::GetStageMicroNode(const UsdStagePtr& stage)
 {
+    _Lock();
     return _cache._impl->GetStageMicroNode(stage);
 }
 
@@ -1753,8 +2701,16 @@ GusdStageCacheReader::GetPrim(const UT_StringRef& path,
 {
     PrimStagePair pair;
     if (path && _IsValidPrimPath(primPath)) {
-        if((pair.second = _cache._impl->FindOrOpenMaskedStage(
-               path, opts, edit, primPath, sev))) {
+
+        // A full stage always satisfies the request, and can be found
+        // without locking.
+        pair.second = _cache._impl->FindStageInSnapshot(path, opts, edit);
+        if(!pair.second) {
+            _Lock();
+            pair.second = _cache._impl->FindOrOpenMaskedStage(
+                path, opts, edit, primPath, sev);
+        }
+        if(pair.second) {
 
             pair.first =
                 GusdUSD_Utils::GetPrimFromStage(pair.second, primPath, sev);
@@ -1838,6 +2794,7 @@ GusdStageCacheReader::GetPrims(
     const GusdStageOpts& opts,
     UT_ErrorSeverity sev)
 {
+    _Lock();
     return _cache._impl->LoadPrims(filePaths, primPaths,
                                    edits, prims, opts, sev);
 }
@@ -1879,6 +2836,21 @@ GusdStageCacheWriter::InsertStage(UsdStageRefPtr &stage,
     _cache._impl->InsertStage(stage, path, opts, edit);
 }
 
+void
+GusdStageCacheWriter::EvictToBudget()
+{
+    _cache._impl->UpdateMemoryEstimates();
+    _cache._impl->EvictToBudget(/*propagateDirty*/ true);
+}
+
+
+void
+GusdStageCacheWriter::GetStats(GusdStageCache::Stats& stats) const
+{
+    _cache._impl->GetStats(stats);
+}
+
+
 void
 GusdStageCacheWriter::ReloadStages(const UT_StringSet& paths)
 {
@@ -27,6 +27,7 @@
 #include <UT/UT_Array.h>
 #include <UT/UT_Error.h>
 #include <UT/UT_Set.h>
+#include <UT/UT_StringHolder.h>
 
 #include "gusd/defaultArray.h"
 #include "gusd/stageEdit.h"
@@ -37,9 +38,11 @@
 #include "pxr/usd/sdf/layer.h"
 #include "pxr/usd/usd/stage.h"
 
+#include <atomic>
+#include <mutex>
+
 
 class DEP_MicroNode;
-class UT_StringHolder;
 class UT_StringSet;
 
 
@@ -106,6 +109,62 @@ public:
     /// Mark a set of layers for reload on the event queue.
     static void ReloadLayers(const UT_Set<SdfLayerHandle>& layers);
 
+    /// \section GusdStageCache_MemoryBudget Memory Budget
+    ///
+    /// The cache may be given a memory budget, beyond which the least
+    /// recently used stages are evicted. Only stages that are not referenced
+    /// outside of the cache are considered for eviction, and stages inserted
+    /// with GusdStageCacheWriter::InsertStage() are never evicted.
+    /// Eviction behaves like a partial Clear() of the evicted stages: micro
+    /// nodes of evicted stages are dirtied, and auxiliary data caches are
+    /// cleared for the evicted paths. Since dirty propagation is only safe
+    /// on the main thread, eviction only happens when a cache accessor is
+    /// released on the main thread with no other accessors active.
+    ///
+    /// Stage memory is an estimate based on the number of composed prims,
+    /// as USD does not report the footprint of a stage. Estimates are made
+    /// when the budget is checked, and are redone for stages that have
+    /// changed since, e.g. by loading payloads.
+    ///
+    /// The initial budget is read from the GUSD_STAGECACHE_MAX_MEMORY_MB
+    /// environment setting.
+
+    /// Set the memory budget of the cache, in bytes.
+    /// A value <= 0 disables eviction.
+    void    SetMaxMemory(int64 bytes);
+
+    int64   GetMaxMemory() const;
+
+    /// Statistics for a single stage held by the cache.
+    struct StageStats
+    {
+        UT_StringHolder path;
+        int64           memory = 0;
+        int64           hits = 0;
+        bool            masked = false;
+        bool            pinned = false;
+    };
+
+    /// Record of a stage evicted by the memory budget.
+    struct EvictionRecord
+    {
+        UT_StringHolder path;
+        int64           memory = 0;
+        bool            masked = false;
+    };
+
+    struct Stats
+    {
+        UT_Array<StageStats>        stages;
+        /// Most recent evictions, oldest first.
+        UT_Array<EvictionRecord>    evictions;
+        int64                       hits = 0;
+        int64                       misses = 0;
+        int64                       numEvicted = 0;
+        int64                       memory = 0;
+        int64                       maxMemory = 0;
+    };
+
 
 private:
     class _MaskedStageCache;
@@ -124,6 +183,11 @@ private:
 /// Cache readers cannot clear out any existing stages or mutate
 /// auxiliary data caches.
 ///
+/// Lookups of stages that are already on the cache read from an immutable
+/// snapshot of the cache and do not take any locks. A reader only acquires
+/// a shared lock on the cache the first time it needs to open or insert a
+/// stage, or access masked stages, and then holds it until destruction.
+///
 /// Example usage:
 /// @code
 ///     GusdStageCacheReader cache;
@@ -285,9 +349,14 @@ public:
 protected:
     GusdStageCacheReader(GusdStageCache& cache, bool writer);
 
+    /// Acquire a shared lock on the cache, if not already held.
+    void    _Lock() const;
+
 protected:
-    GusdStageCache& _cache;
-    const bool      _writer;
+    GusdStageCache&             _cache;
+    const bool                  _writer;
+    mutable std::once_flag      _lockOnce;
+    mutable std::atomic<bool>   _locked;
 };
 
 
@@ -351,6 +420,14 @@ public:
     /// Reload all stages matching the given paths.
     void    ReloadStages(const UT_StringSet& paths);
 
+    /// Evict least recently used stages until the cache is within its
+    /// memory budget. See \ref GusdStageCache_MemoryBudget.
+    /// As with Clear(), this should only be called on the main thread.
+    void    EvictToBudget();
+
+    /// Query memory usage, hit/miss counts and eviction history.
+    void    GetStats(GusdStageCache::Stats& stats) const;
+
 };
 
 
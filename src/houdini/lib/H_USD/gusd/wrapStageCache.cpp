@@ -210,6 +210,51 @@ _ReloadStages(GusdStageCache& self, const list& paths)
 }
 
 
+dict
+_GetStats(GusdStageCache& self)
+{
+    GusdStageCache::Stats stats;
+    GusdStageCacheWriter(self).GetStats(stats);
+
+    list stages;
+    for(const auto& stageStats : stats.stages) {
+        dict d;
+        d["path"] = stageStats.path.toStdString();
+        d["memory"] = stageStats.memory;
+        d["hits"] = stageStats.hits;
+        d["masked"] = stageStats.masked;
+        d["pinned"] = stageStats.pinned;
+        stages.append(d);
+    }
+
+    list evictions;
+    for(const auto& record : stats.evictions) {
+        dict d;
+        d["path"] = record.path.toStdString();
+        d["memory"] = record.memory;
+        d["masked"] = record.masked;
+        evictions.append(d);
+    }
+
+    dict result;
+    result["stages"] = stages;
+    result["evictions"] = evictions;
+    result["hits"] = stats.hits;
+    result["misses"] = stats.misses;
+    result["numEvicted"] = stats.numEvicted;
+    result["memory"] = stats.memory;
+    result["maxMemory"] = stats.maxMemory;
+    return result;
+}
+
+
+void
+_EvictToBudget(GusdStageCache& self)
+{
+    GusdStageCacheWriter(self).EvictToBudget();
+}
+
+
 void wrapGusdStageCache()
 {
     using This = GusdStageCache;
@@ -257,5 +302,10 @@ void wrapGusdStageCache()
         .def("FindStages", &_FindStages, (arg("paths")))
 
         .def("ReloadStages", &_ReloadStages, (arg("paths")))
+
+        .def("SetMaxMemory", &This::SetMaxMemory, (arg("bytes")))
+        .def("GetMaxMemory", &This::GetMaxMemory)
+        .def("EvictToBudget", &_EvictToBudget)
+        .def("GetStats", &_GetStats)
         ;
 }